@@ -0,0 +1,98 @@
+#include "AllocationCounter.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+static std::atomic<unsigned long long> allocations(0);
+static std::atomic<unsigned long long> allocated_bytes(0);
+
+bool AllocationCounter::IsEnabled()
+{
+#ifdef CUCKOO_COUNT_ALLOCATIONS
+	return true;
+#else
+	return false;
+#endif
+};
+
+unsigned long long AllocationCounter::GetAllocations()
+{
+	return allocations.load(std::memory_order_relaxed);
+};
+
+unsigned long long AllocationCounter::GetAllocatedBytes()
+{
+	return allocated_bytes.load(std::memory_order_relaxed);
+};
+
+void AllocationCounter::AddAllocation(std::size_t bytes)
+{
+	allocations.fetch_add(1, std::memory_order_relaxed);
+	allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+};
+
+#ifdef CUCKOO_COUNT_ALLOCATIONS
+
+static void* CountedAllocation(std::size_t bytes)
+{
+	AllocationCounter::AddAllocation(bytes);
+	void* memory = std::malloc(bytes ? bytes : 1);
+	if (!memory)
+		throw std::bad_alloc();
+	return memory;
+};
+
+void* operator new(std::size_t bytes)
+{
+	return CountedAllocation(bytes);
+};
+
+void* operator new[](std::size_t bytes)
+{
+	return CountedAllocation(bytes);
+};
+
+void* operator new(std::size_t bytes, const std::nothrow_t&) noexcept
+{
+	AllocationCounter::AddAllocation(bytes);
+	return std::malloc(bytes ? bytes : 1);
+};
+
+void* operator new[](std::size_t bytes, const std::nothrow_t&) noexcept
+{
+	AllocationCounter::AddAllocation(bytes);
+	return std::malloc(bytes ? bytes : 1);
+};
+
+void operator delete(void* memory) noexcept
+{
+	std::free(memory);
+};
+
+void operator delete[](void* memory) noexcept
+{
+	std::free(memory);
+};
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+};
+
+void operator delete[](void* memory, std::size_t) noexcept
+{
+	std::free(memory);
+};
+
+void operator delete(void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+};
+
+void operator delete[](void* memory, const std::nothrow_t&) noexcept
+{
+	std::free(memory);
+};
+
+#endif
@@ -0,0 +1,30 @@
+/*
+	Description:
+		Counter of heap allocations for benchmarks: steady-state generation of search
+		doesn't allocate memory, counter shows it. Exception is evaluation cache:
+		each point, which is added into cache, is allocated (its coordinates and entry).
+		Allocations of objective function itself are counted too.
+		Counting is compiled only with CUCKOO_COUNT_ALLOCATIONS defined (project settings or
+		compiler option): AllocationCounter.cpp replaces global operator new by counting one.
+		Without it counters stay zero.
+		Counters are shared by all threads, so allocations of other threads are counted too.
+*/
+
+#ifndef ALLOCATION_COUNTER
+#define ALLOCATION_COUNTER
+
+#include <cstddef>
+
+class AllocationCounter
+{
+public:
+	static bool IsEnabled();
+	static unsigned long long GetAllocations();
+	static unsigned long long GetAllocatedBytes();
+	static void AddAllocation(std::size_t bytes);
+
+private:
+	AllocationCounter() = delete;
+};
+
+#endif // !ALLOCATION_COUNTER
@@ -0,0 +1,298 @@
+#include "AsyncCuckooSearch.h"
+
+AsyncCuckooSearch::AsyncCuckooSearch(ObjectiveFunction func, unsigned amount_of_nests, Step step, Lambda lambda, double prob,
+	unsigned max_generations, StopCritearian stop_crierian, bool use_lazy_cuckoo) :
+	CuckooSearch(func, amount_of_nests, step, lambda, prob, max_generations, stop_crierian, use_lazy_cuckoo),
+	m_workers_count(0), m_queue_depth(0), m_in_flight(0), m_in_flight_evaluations(0), m_next_nest(0), m_stop(false)
+{
+};
+
+AsyncCuckooSearch::AsyncCuckooSearch(const CuckooSearch& cuckoo_search) :
+	CuckooSearch(cuckoo_search), m_workers_count(0), m_queue_depth(0), m_in_flight(0), m_in_flight_evaluations(0), m_next_nest(0), m_stop(false)
+{
+};
+
+AsyncCuckooSearch::~AsyncCuckooSearch()
+{
+	StopWorkers();
+};
+
+void AsyncCuckooSearch::StartSearch()
+{
+	StopWorkers();
+	CuckooSearch::StartSearch();
+	m_random_engine = GetRandomEngine(FLIGHT, m_amount_of_nests);
+	m_next_nest = 0;
+	StartWorkers();
+};
+
+void AsyncCuckooSearch::RestoreCheckpoint(const SearchCheckpoint& checkpoint)
+{
+	StopWorkers();
+	CuckooSearch::RestoreCheckpoint(checkpoint);
+	//Flights in queue aren't saved, resumed search continues with new flights
+	m_random_engine = GetRandomEngine(FLIGHT, m_amount_of_nests);
+	m_next_nest = 0;
+	StartWorkers();
+};
+
+bool AsyncCuckooSearch::NextGeneration()
+{
+	if (IsStopped())
+	{
+		StopWorkers();
+		return false;
+	}
+	if (m_population.GetSize() == 0)
+		throw std::runtime_error("Search isn't started: call StartMin or StartMax before NextGeneration\n");
+	//Copy of search and search, which was stopped, have no workers
+	if (m_workers.empty())
+	{
+		StartWorkers();
+	}
+
+	if (m_statistics_handler)
+	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::STATISTICS_HANDLER);
+		m_statistics_handler();
+	}
+
+	RecalculateLambdas();
+	RecalculateStep();
+
+	const unsigned int workers = static_cast<unsigned int>(m_workers.size());
+	const unsigned int depth = (m_queue_depth == 0) ? 2 * workers : std::max(1u, m_queue_depth);
+	unsigned int processed = 0;
+	while (processed < m_amount_of_nests && !IsBudgetExhausted())
+	{
+		while (m_in_flight < depth && CanSubmit(FLIGHT_TASK))
+		{
+			Submit(FLIGHT_TASK);
+		}
+		//The rest of budget is less than evaluations of flight
+		if (m_in_flight == 0)
+		{
+			m_stop_reason = StopReason::MAX_EVALUATIONS;
+			break;
+		}
+
+		std::unique_ptr<Task> task;
+		{
+			CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::QUEUE_WAIT);
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_task_completed.wait(lock, [&]() { return !m_completed.empty(); });
+			task = std::move(m_completed.front());
+			m_completed.pop_front();
+		}
+		--m_in_flight;
+		m_in_flight_evaluations -= task->fitness.size();
+		CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::EVALUATIONS, task->fitness.size());
+		m_evaluations += task->fitness.size();
+		if (task->error)
+		{
+			const std::exception_ptr error = task->error;
+			StopWorkers();
+			std::rethrow_exception(error);
+		}
+
+		if (task->type == FLIGHT_TASK)
+		{
+			++processed;
+			//Generational search abandons abandon_probability / 2 of nests on average
+			if (m_random_engine.Uniform() < m_abandon_probability / 2.0 && CanSubmit(ABANDON_TASK))
+			{
+				Submit(ABANDON_TASK);
+			}
+		}
+		Complete(*task);
+		m_free_tasks.push_back(std::move(task));
+	}
+	//Generation without flights doesn't change population
+	if (processed == 0 && m_stop_reason == StopReason::MAX_EVALUATIONS)
+	{
+		StopWorkers();
+		return false;
+	}
+
+	RankNests();
+	UpdateBestEver(m_ranking.GetBest(), m_ranking.GetBest() + 1);
+	UpdateStagnation();
+	++m_current_generation;
+	ScheduleCheckpoint();
+	return true;
+};
+
+void AsyncCuckooSearch::StartWorkers()
+{
+	const unsigned int workers = (m_workers_count == 0) ? m_executor->GetNumberOfThreads() : m_workers_count;
+	m_stop = false;
+	for (unsigned int i = 0; i < workers; ++i)
+	{
+		m_workers.push_back(std::thread(&AsyncCuckooSearch::WorkerLoop, this));
+	}
+};
+
+void AsyncCuckooSearch::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_task_ready.notify_all();
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+	m_workers.clear();
+
+	//Results of unprocessed flights are dropped, but finished evaluations are counted
+	for (auto& task : m_pending)
+	{
+		m_free_tasks.push_back(std::move(task));
+	}
+	for (auto& task : m_completed)
+	{
+		m_evaluations += task->fitness.size();
+		m_free_tasks.push_back(std::move(task));
+	}
+	m_pending.clear();
+	m_completed.clear();
+	m_in_flight = 0;
+	m_in_flight_evaluations = 0;
+	m_stop = false;
+};
+
+void AsyncCuckooSearch::WorkerLoop()
+{
+	while (true)
+	{
+		std::unique_ptr<Task> task;
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_task_ready.wait(lock, [&]() { return m_stop || !m_pending.empty(); });
+			if (m_stop)
+				return;
+			task = std::move(m_pending.front());
+			m_pending.pop_front();
+		}
+
+		const unsigned int dimensions = m_population.GetDimensions();
+		try
+		{
+			if (task->changed_count < dimensions && m_evaluated_function.HasIncrementalFunction())
+			{
+				for (unsigned int i = 0; i < task->fitness.size(); ++i)
+				{
+					task->fitness[i] = m_evaluated_function.EvaluateChange(&task->candidates[i * dimensions], task->host.data(),
+						task->host_fitness, task->changed.data(), task->changed_count);
+				}
+			}
+			else
+			{
+				m_evaluated_function.Evaluate(task->candidates.data(), static_cast<unsigned int>(task->fitness.size()),
+					dimensions, task->fitness.data());
+			}
+		}
+		catch (...)
+		{
+			task->error = std::current_exception();
+		}
+
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_completed.push_back(std::move(task));
+		}
+		m_task_completed.notify_one();
+	}
+};
+
+bool AsyncCuckooSearch::CanSubmit(TaskType type) const
+{
+	if (m_budget.GetMaxEvaluations() == 0)
+		return true;
+	const unsigned int evaluations = (type == FLIGHT_TASK) ? m_cuckoo->GetNumberOfCandidates() : 1;
+	return m_evaluations + m_in_flight_evaluations + evaluations <= m_budget.GetMaxEvaluations();
+};
+
+void AsyncCuckooSearch::Submit(TaskType type)
+{
+	std::unique_ptr<Task> task;
+	if (m_free_tasks.empty())
+	{
+		task.reset(new Task());
+	}
+	else
+	{
+		task = std::move(m_free_tasks.back());
+		m_free_tasks.pop_back();
+	}
+	task->type = type;
+	task->error = nullptr;
+
+	//Flight starts from copy of host, host can be replaced before flight is evaluated
+	const unsigned int dimensions = m_population.GetDimensions();
+	if (type == FLIGHT_TASK)
+	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::FLIGHT_GENERATION);
+		const unsigned int nest = m_ranking[m_next_nest];
+		m_next_nest = (m_next_nest + 1) % m_amount_of_nests;
+		const double* host = m_population.GetSolution(nest);
+		task->host.assign(host, host + dimensions);
+		task->host_fitness = m_population.GetFitness(nest);
+		task->candidates.resize(m_cuckoo->GetNumberOfCandidates() * dimensions);
+		task->fitness.resize(m_cuckoo->GetNumberOfCandidates());
+		task->changed.resize(std::max(1u, m_cuckoo->GetSubspaceSize()));
+		task->changed_count = m_cuckoo->GenerateCandidates(host, m_population.GetLambda(nest), &m_alpha[0], m_bounds, m_random_engine,
+			task->candidates.data(), dimensions, task->changed.data());
+	}
+	else
+	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::ABANDON);
+		task->candidates.resize(dimensions);
+		task->fitness.resize(1);
+		task->changed_count = dimensions;
+		Population::GenerateSolution(task->candidates.data(), m_bounds, m_random_engine);
+		if (m_constraints)
+		{
+			m_constraints->Repair(task->candidates.data(), m_bounds);
+		}
+	}
+
+	const size_t task_evaluations = task->fitness.size();
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending.push_back(std::move(task));
+	}
+	++m_in_flight;
+	m_in_flight_evaluations += task_evaluations;
+	m_task_ready.notify_one();
+};
+
+void AsyncCuckooSearch::Complete(Task& task)
+{
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::REPLACEMENT);
+	const unsigned int dimensions = m_population.GetDimensions();
+	if (task.type == FLIGHT_TASK)
+	{
+		const int chosen = m_cuckoo->SelectCandidate(task.host_fitness, task.fitness.data(), m_cmp_fitness);
+		const double* solution = (chosen == Cuckoo::HOST_CANDIDATE) ? task.host.data() : &task.candidates[chosen * dimensions];
+		const double fitness = (chosen == Cuckoo::HOST_CANDIDATE) ? task.host_fitness : task.fitness[chosen];
+		const unsigned int target = m_random_engine.UniformIndex(m_amount_of_nests);
+		if (m_cmp_fitness(fitness, m_population.GetFitness(target)))
+		{
+			m_population.Assign(target, solution, fitness);
+			m_ranking.MarkChanged(target);
+			UpdateBestEver(target, target + 1);
+			CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::REPLACEMENTS, 1);
+		}
+		return;
+	}
+
+	//Abandoned nest is the worst nest at the moment of completion
+	RankNests();
+	const unsigned int worst = m_ranking.GetWorst();
+	m_population.Assign(worst, task.candidates.data(), task.fitness[0]);
+	m_ranking.MarkChanged(worst);
+	UpdateBestEver(worst, worst + 1);
+	CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::ABANDONMENTS, 1);
+};
@@ -0,0 +1,99 @@
+/*
+	Description:
+		Asynchronous steady-state cuckoo search for slow objectives with varying
+		evaluation time. There is no barrier between generations:
+		coordinator (calling thread) generates flights and puts them into queue,
+		workers evaluate them, and coordinator replaces nests by results in order
+		of completion, so workers don't wait for the slowest evaluation of generation.
+		Queue depth limits number of flights, which are generated but not processed yet
+		(deeper queue - workers idle less, but flights start from older nests).
+		Abandoned nests are evaluated by workers too: random nest replaces the worst nest,
+		on average as many nests as in generational search are abandoned.
+		Generation is amount_of_nests processed flights: after it nests are ranked,
+		lambdas and step are recalculated, statistics handler is called.
+		Order of completions depends on timing, so results aren't reproducible even with fixed seed.
+		Checkpoint doesn't keep flights in queue, so resumed search continues with new flights.
+		Flights are submitted only while their evaluations fit into budget of evaluations (search stops,
+		when the rest of budget is less than evaluations of flight);
+		evaluations, which are finished, when search stops, are counted too.
+		Workers are started by StartMin (StartMax), copy of started search starts them
+		in the first NextGeneration.
+*/
+
+#ifndef ASYNC_CUCKOO_SEARCH
+#define ASYNC_CUCKOO_SEARCH
+
+#include "CuckooSearch.h"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <deque>
+#include <vector>
+#include <memory>
+#include <exception>
+
+class AsyncCuckooSearch : public CuckooSearch
+{
+public:
+	AsyncCuckooSearch(ObjectiveFunction func, unsigned amount_of_nests = 32, Step step = 1.0, Lambda lambda = { 0.3, 1.99 }, double prob = 0.25,
+		unsigned max_generations = 10000, StopCritearian stop_crierian = []() {return true; }, bool use_lazy_cuckoo = false);
+	AsyncCuckooSearch(const CuckooSearch& cuckoo_search);
+	virtual ~AsyncCuckooSearch();
+
+	virtual bool NextGeneration();
+	virtual void RestoreCheckpoint(const SearchCheckpoint& checkpoint);
+
+	//workers = 0 - number of threads of executor
+	inline void SetNumberOfWorkers(unsigned int workers) { m_workers_count = workers; };
+	//depth = 0 - two flights for each worker
+	inline void SetQueueDepth(unsigned int depth) { m_queue_depth = depth; };
+	inline unsigned int GetNumberOfWorkers() const { return m_workers_count; };
+	inline unsigned int GetQueueDepth() const { return m_queue_depth; };
+
+protected:
+	enum TaskType { FLIGHT_TASK, ABANDON_TASK };
+
+	struct Task
+	{
+		TaskType			type;
+		std::vector<double>	host;
+		double				host_fitness;
+		std::vector<double>	candidates;
+		std::vector<double>	fitness;
+		//Coordinates, where candidates differ from host
+		std::vector<unsigned int>	changed;
+		unsigned int		changed_count;
+		std::exception_ptr	error;
+	};
+
+	unsigned int						m_workers_count;
+	unsigned int						m_queue_depth;
+	std::vector<std::thread>			m_workers;
+	std::deque<std::unique_ptr<Task>>	m_pending;
+	std::deque<std::unique_ptr<Task>>	m_completed;
+	std::vector<std::unique_ptr<Task>>	m_free_tasks;
+	unsigned int						m_in_flight;
+	//Evaluations of tasks, which are submitted, but not processed yet
+	unsigned long long					m_in_flight_evaluations;
+	unsigned int						m_next_nest;
+	std::mutex							m_mutex;
+	std::condition_variable				m_task_ready;
+	std::condition_variable				m_task_completed;
+	bool								m_stop;
+	RandomEngine						m_random_engine;
+
+	virtual void StartSearch();
+	void StartWorkers();
+	void StopWorkers();
+	void WorkerLoop();
+	bool CanSubmit(TaskType type) const;
+	void Submit(TaskType type);
+	void Complete(Task& task);
+
+private:
+	AsyncCuckooSearch(const AsyncCuckooSearch&) = delete;
+	AsyncCuckooSearch& operator=(const AsyncCuckooSearch&) = delete;
+};
+
+#endif // !ASYNC_CUCKOO_SEARCH
@@ -0,0 +1,62 @@
+/*
+	Description:
+		Benchmark functions based on kernels of Kernels.h.
+		MakeKernelFunction creates ObjectiveFunction with point and batch functions
+		based on kernel: batch function calls kernel of active instruction set
+		(KernelDispatch), point function uses kernel compiled with flags of program.
+		Separable kernels (sum of terms of coordinates) have Term, so
+		MakeSeparableKernelFunction adds incremental function, which replaces
+		terms of changed coordinates only.
+*/
+
+#ifndef BENCHMARK_KERNELS
+#define BENCHMARK_KERNELS
+
+#include "FunctionHelper.h"
+#include "Kernels.h"
+#include "KernelDispatch.h"
+
+#include <string>
+
+//Block of points is evaluated by kernel of active instruction set
+template <KernelId Id>
+inline void EvaluateDispatchedKernel(const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness)
+{
+	KernelDispatch::GetKernels().objective[static_cast<unsigned int>(Id)](points, count, dimensions, stride, fitness);
+};
+
+template <template <unsigned int> class Kernel>
+inline ObjectiveFunction MakeKernelFunction(unsigned int dimensions, Bounds bounds, std::string function_name)
+{
+	ObjectiveFunction function(
+		[](const std::valarray<double>& args)
+	{
+		return Kernel<0>::Evaluate(&args[0], static_cast<unsigned int>(args.size()));
+	}, dimensions, bounds, function_name);
+	function.SetBatchFunction(&EvaluateDispatchedKernel<Kernel<0>::ID>);
+	return function;
+};
+
+//Fitness of point, which differs from previous point in changed coordinates
+template <template <unsigned int> class Kernel>
+inline double EvaluateSeparableChange(const double* point, const double* previous_point, double previous_fitness,
+	const unsigned int* changed, unsigned int count)
+{
+	double change = 0.0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int coordinate = changed[i];
+		change += Kernel<0>::Term(point[coordinate]) - Kernel<0>::Term(previous_point[coordinate]);
+	}
+	return previous_fitness + change;
+};
+
+template <template <unsigned int> class Kernel>
+inline ObjectiveFunction MakeSeparableKernelFunction(unsigned int dimensions, Bounds bounds, std::string function_name)
+{
+	ObjectiveFunction function = MakeKernelFunction<Kernel>(dimensions, bounds, function_name);
+	function.SetIncrementalFunction(&EvaluateSeparableChange<Kernel>);
+	return function;
+};
+
+#endif // !BENCHMARK_KERNELS
@@ -0,0 +1,210 @@
+#include "BenchmarkRunner.h"
+#include "AllocationCounter.h"
+
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+
+const void* volatile benchmark_sink = nullptr;
+
+BenchmarkState::BenchmarkState(unsigned long long iterations) :
+	m_iterations(iterations), m_remaining(iterations), m_items(0), m_seconds(0.0), m_allocations(0),
+	m_running(false), m_start_allocations(0)
+{
+};
+
+bool BenchmarkState::KeepRunning()
+{
+	if (!m_running && m_remaining == m_iterations)
+	{
+		ResumeTiming();
+	}
+	if (m_remaining == 0)
+	{
+		PauseTiming();
+		return false;
+	}
+	--m_remaining;
+	return true;
+};
+
+void BenchmarkState::PauseTiming()
+{
+	if (!m_running)
+		return;
+	m_seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+	m_allocations += AllocationCounter::GetAllocations() - m_start_allocations;
+	m_running = false;
+};
+
+void BenchmarkState::ResumeTiming()
+{
+	if (m_running)
+		return;
+	m_running = true;
+	m_start_allocations = AllocationCounter::GetAllocations();
+	m_start = std::chrono::steady_clock::now();
+};
+
+BenchmarkRunner::BenchmarkRunner() :
+	m_min_time(0.2), m_repetitions(3)
+{
+};
+
+void BenchmarkRunner::Register(const std::string& name, BenchmarkFunction function)
+{
+	m_benchmarks.push_back({ name, function });
+};
+
+void BenchmarkRunner::Run(const std::string& filter)
+{
+	m_results.clear();
+	std::cout << std::left << std::setw(48) << "Benchmark" << std::right << std::setw(16) << "Time, ns" <<
+		std::setw(14) << "Iterations" << std::setw(16) << "Items/s" << std::setw(10) << "Allocs" << "\n";
+	for (const Benchmark& benchmark : m_benchmarks)
+	{
+		if (benchmark.name.find(filter) == std::string::npos)
+			continue;
+		m_results.push_back(RunBenchmark(benchmark));
+		const BenchmarkResult& result = m_results.back();
+		std::cout << std::left << std::setw(48) << result.name << std::right << std::fixed << std::setprecision(1) <<
+			std::setw(16) << result.nanoseconds << std::setw(14) << result.iterations << std::scientific << std::setprecision(3) <<
+			std::setw(16) << result.items_per_second << std::fixed << std::setprecision(1) << std::setw(10);
+		if (AllocationCounter::IsEnabled())
+			std::cout << result.allocations;
+		else
+			std::cout << "-";
+		std::cout << "\n" << std::defaultfloat;
+	}
+};
+
+BenchmarkResult BenchmarkRunner::RunBenchmark(const Benchmark& benchmark) const
+{
+	//Number of iterations grows, until run is long enough to be measured
+	unsigned long long iterations = 1;
+	while (true)
+	{
+		BenchmarkState state(iterations);
+		benchmark.function(state);
+		if (state.GetSeconds() >= m_min_time || iterations >= 1000000000ull)
+			break;
+		const double multiplier = (state.GetSeconds() > 0.0) ? 1.4 * m_min_time / state.GetSeconds() : 10.0;
+		iterations = std::max(iterations + 1, static_cast<unsigned long long>(iterations * std::min(10.0, multiplier)));
+	}
+
+	std::vector<BenchmarkResult> repetitions;
+	for (unsigned int i = 0; i < m_repetitions; ++i)
+	{
+		BenchmarkState state(iterations);
+		benchmark.function(state);
+		BenchmarkResult result;
+		result.name = benchmark.name;
+		result.iterations = iterations;
+		result.nanoseconds = state.GetSeconds() * 1e9 / double(iterations);
+		result.items_per_second = (state.GetSeconds() > 0.0) ? double(state.GetItemsProcessed()) / state.GetSeconds() : 0.0;
+		result.allocations = double(state.GetAllocations()) / double(iterations);
+		repetitions.push_back(result);
+	}
+	std::sort(repetitions.begin(), repetitions.end(), [](const BenchmarkResult& ls, const BenchmarkResult& rs)
+	{
+		return ls.nanoseconds < rs.nanoseconds;
+	});
+	return repetitions[repetitions.size() / 2];
+};
+
+void BenchmarkRunner::WriteJson(std::ostream& o_stream) const
+{
+	o_stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+	o_stream << "{\n";
+	o_stream << "\t\"repetitions\": " << m_repetitions << ",\n";
+	o_stream << "\t\"min_time\": " << m_min_time << ",\n";
+	o_stream << "\t\"count_allocations\": " << (AllocationCounter::IsEnabled() ? "true" : "false") << ",\n";
+	for (const auto& context : m_context)
+	{
+		o_stream << "\t\"" << context.first << "\": \"" << context.second << "\",\n";
+	}
+	o_stream << "\t\"benchmarks\": [";
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const BenchmarkResult& result = m_results[i];
+		o_stream << (i == 0 ? "\n" : ",\n");
+		o_stream << "\t\t{ \"name\": \"" << result.name << "\", \"iterations\": " << result.iterations <<
+			", \"real_time\": " << result.nanoseconds << ", \"time_unit\": \"ns\"" <<
+			", \"items_per_second\": " << result.items_per_second << ", \"allocations\": " << result.allocations << " }";
+	}
+	o_stream << "\n\t]\n}\n";
+};
+
+//Reader of JSON written by WriteJson: each benchmark is one object with known fields
+static std::string GetJsonField(const std::string& object, const std::string& field)
+{
+	const std::string key = "\"" + field + "\":";
+	const size_t position = object.find(key);
+	if (position == std::string::npos)
+		return std::string();
+	size_t begin = object.find_first_not_of(" \t", position + key.size());
+	if (begin == std::string::npos)
+		return std::string();
+	if (object[begin] == '"')
+	{
+		const size_t end = object.find('"', begin + 1);
+		return object.substr(begin + 1, end - begin - 1);
+	}
+	const size_t end = object.find_first_of(",}", begin);
+	return object.substr(begin, end - begin);
+};
+
+std::vector<BenchmarkResult> BenchmarkRunner::ReadJson(const std::string& file_path)
+{
+	std::ifstream file(file_path);
+	if (!file)
+		throw std::runtime_error("Can't open benchmark results " + file_path + "\n");
+	std::stringstream buffer;
+	buffer << file.rdbuf();
+	const std::string text = buffer.str();
+
+	std::vector<BenchmarkResult> results;
+	size_t position = text.find("\"benchmarks\"");
+	if (position == std::string::npos)
+		throw std::runtime_error(file_path + " doesn't contain benchmarks\n");
+	while ((position = text.find('{', position)) != std::string::npos)
+	{
+		const size_t end = text.find('}', position);
+		if (end == std::string::npos)
+			break;
+		const std::string object = text.substr(position, end - position + 1);
+		BenchmarkResult result;
+		result.name = GetJsonField(object, "name");
+		result.iterations = std::stoull(GetJsonField(object, "iterations"));
+		result.nanoseconds = std::stod(GetJsonField(object, "real_time"));
+		result.items_per_second = std::stod(GetJsonField(object, "items_per_second"));
+		result.allocations = std::stod(GetJsonField(object, "allocations"));
+		results.push_back(result);
+		position = end + 1;
+	}
+	return results;
+};
+
+std::vector<BenchmarkComparison> BenchmarkRunner::Compare(const std::string& baseline_path, double threshold) const
+{
+	const std::vector<BenchmarkResult> baseline = ReadJson(baseline_path);
+	std::vector<BenchmarkComparison> comparisons;
+	for (const BenchmarkResult& result : m_results)
+	{
+		auto base = std::find_if(baseline.begin(), baseline.end(), [&](const BenchmarkResult& value) { return value.name == result.name; });
+		if (base == baseline.end() || base->nanoseconds <= 0.0)
+			continue;
+		BenchmarkComparison comparison;
+		comparison.name = result.name;
+		comparison.baseline_nanoseconds = base->nanoseconds;
+		comparison.nanoseconds = result.nanoseconds;
+		comparison.change = result.nanoseconds / base->nanoseconds - 1.0;
+		comparison.is_regression = comparison.change > threshold;
+		comparisons.push_back(comparison);
+	}
+	return comparisons;
+};
@@ -0,0 +1,120 @@
+/*
+	Description:
+		Microbenchmark runner in style of Google Benchmark.
+		Benchmark is function, which gets BenchmarkState and repeats measured code in
+		loop "while (state.KeepRunning())", code before loop is setup and isn't measured.
+		Runner calls benchmark with growing number of iterations, until run takes
+		min_time, after that run is repeated and median time of iteration is taken.
+		Heap allocations per iteration are counted too, if program is built with
+		CUCKOO_COUNT_ALLOCATIONS (see AllocationCounter.h).
+		Results are written as JSON and can be compared with JSON of previous run (baseline):
+		benchmark, which is slower than baseline more than threshold, is regression.
+*/
+
+#ifndef BENCHMARK_RUNNER
+#define BENCHMARK_RUNNER
+
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <ostream>
+#include <utility>
+
+class BenchmarkState
+{
+public:
+	BenchmarkState(unsigned long long iterations);
+
+	//Returns true while iterations aren't finished, timer starts on first call
+	bool KeepRunning();
+	//Code between PauseTiming and ResumeTiming isn't measured
+	void PauseTiming();
+	void ResumeTiming();
+	//Items (points, nests, ...) processed by all iterations, runner reports items per second
+	inline void SetItemsProcessed(unsigned long long items) { m_items = items; };
+
+	inline unsigned long long GetIterations() const { return m_iterations; };
+	inline unsigned long long GetItemsProcessed() const { return m_items; };
+	inline double GetSeconds() const { return m_seconds; };
+	inline unsigned long long GetAllocations() const { return m_allocations; };
+
+private:
+	unsigned long long	m_iterations;
+	unsigned long long	m_remaining;
+	unsigned long long	m_items;
+	double				m_seconds;
+	unsigned long long	m_allocations;
+	bool				m_running;
+	std::chrono::steady_clock::time_point	m_start;
+	unsigned long long	m_start_allocations;
+};
+
+using BenchmarkFunction = std::function<void(BenchmarkState&)>;
+
+struct BenchmarkResult
+{
+	std::string		name;
+	unsigned long long	iterations;
+	//Median time of iteration
+	double			nanoseconds;
+	double			items_per_second;
+	double			allocations;
+};
+
+struct BenchmarkComparison
+{
+	std::string		name;
+	double			baseline_nanoseconds;
+	double			nanoseconds;
+	//Relative change of time: 0.1 - 10% slower
+	double			change;
+	bool			is_regression;
+};
+
+class BenchmarkRunner
+{
+public:
+	BenchmarkRunner();
+
+	void Register(const std::string& name, BenchmarkFunction function);
+	//Runs benchmarks, which names contain filter
+	void Run(const std::string& filter = "");
+
+	inline void SetMinTime(double seconds) { m_min_time = seconds; };
+	inline void SetRepetitions(unsigned int repetitions) { m_repetitions = repetitions > 0 ? repetitions : 1; };
+	inline const std::vector<BenchmarkResult>& GetResults() const { return m_results; };
+	//Description of run (instruction set, ...), which is written to JSON
+	inline void AddContext(const std::string& name, const std::string& value) { m_context.push_back({ name, value }); };
+
+	void WriteJson(std::ostream& o_stream) const;
+	//Compares results with benchmarks of baseline JSON, threshold 0.1 - 10% slower is regression
+	std::vector<BenchmarkComparison> Compare(const std::string& baseline_path, double threshold) const;
+	static std::vector<BenchmarkResult> ReadJson(const std::string& file_path);
+
+private:
+	struct Benchmark
+	{
+		std::string			name;
+		BenchmarkFunction	function;
+	};
+
+	std::vector<Benchmark>			m_benchmarks;
+	std::vector<BenchmarkResult>	m_results;
+	std::vector<std::pair<std::string, std::string>>	m_context;
+	double							m_min_time;
+	unsigned int					m_repetitions;
+
+	BenchmarkResult RunBenchmark(const Benchmark& benchmark) const;
+};
+
+//Address of value is written to volatile variable, so compiler can't remove computation of value
+extern const void* volatile benchmark_sink;
+
+template <typename T>
+inline void DoNotOptimize(const T& value)
+{
+	benchmark_sink = &value;
+};
+
+#endif // !BENCHMARK_RUNNER
@@ -0,0 +1,322 @@
+/*
+	Description:
+		Entry point of microbenchmark program (separate from Test.cpp, which is entry
+		point of search program): Benchmarks.cpp, BenchmarkRunner.cpp and sources of
+		search without Test.cpp are built as one program (target cuckoo_benchmarks of CMakeLists.txt).
+		Define CUCKOO_COUNT_ALLOCATIONS to see heap allocations per iteration.
+		Kernels of instruction set are chosen by environment variable CUCKOO_ISA (see KernelDispatch.h).
+		Options:
+			--filter text		run benchmarks, which names contain text
+			--min-time seconds	minimum time of measured run
+			--repetitions n		number of measured runs, median is reported
+			--json file			write results as JSON
+			--baseline file		compare results with JSON of previous run
+			--threshold value	relative slowdown, which is regression (0.1 - 10%)
+		Program returns 1, if any benchmark is regression.
+*/
+
+#include "BenchmarkRunner.h"
+#include "CuckooSearch.h"
+#include "KernelDispatch.h"
+#include "LevyFlight.h"
+#include "Ranking.h"
+#include "TestFunctions.h"
+
+#include <iostream>
+#include <fstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <cstdlib>
+
+const double MIN_STEP = 1e-6;
+const double MAX_STEP = 1e-2;
+const double MIN_LAMBDA = 0.3;
+const double MAX_LAMBDA = 1.99;
+const double ABANDON_PROBABILITY = 0.25;
+const std::uint64_t SEED = 42;
+//Number of points in one call of batch function
+const unsigned int BATCH_SIZE = 256;
+
+//Search with access to steps of generation
+class BenchmarkSearch : public CuckooSearch
+{
+public:
+	BenchmarkSearch(ObjectiveFunction func, unsigned int amount_of_nests) :
+		CuckooSearch(func, amount_of_nests, { MIN_STEP, MAX_STEP }, { MIN_LAMBDA, MAX_LAMBDA }, ABANDON_PROBABILITY, 0xFFFFFFFFu)
+	{
+		SetSeed(SEED);
+	};
+
+	using CuckooSearch::RankNests;
+	using CuckooSearch::AbandonNests;
+
+	//Changes fitness of count random nests, as replacement of nests does
+	void ChangeFitness(unsigned int count, RandomEngine& random_engine)
+	{
+		const double worst = m_population.GetFitness(m_ranking.GetWorst());
+		const double best = m_population.GetFitness(m_ranking.GetBest());
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int index = random_engine.UniformIndex(m_amount_of_nests);
+			m_population.SetFitness(index, best + (worst - best) * random_engine.Uniform());
+			m_ranking.MarkChanged(index);
+		}
+	};
+};
+
+static void RegisterLevyFlight(BenchmarkRunner& runner)
+{
+	for (double lambda : { 0.5, 1.5 })
+	{
+		for (unsigned int dimension : { 1u, 30u, 1000u })
+		{
+			runner.Register("LevyFlight::GetValue/lambda:" + std::to_string(lambda).substr(0, 3) + "/dim:" + std::to_string(dimension),
+				[lambda, dimension](BenchmarkState& state)
+			{
+				RandomEngine random_engine(SEED);
+				while (state.KeepRunning())
+				{
+					std::valarray<double> value = LevyFlight::GetValue(lambda, random_engine, dimension);
+					DoNotOptimize(value[0]);
+				}
+				state.SetItemsProcessed(state.GetIterations() * dimension);
+			});
+		}
+		runner.Register("LevyFlight::FillSteps/lambda:" + std::to_string(lambda).substr(0, 3) + "/dim:1000", [lambda](BenchmarkState& state)
+		{
+			RandomEngine random_engine(SEED);
+			std::vector<double> steps(1000);
+			while (state.KeepRunning())
+			{
+				LevyFlight::FillSteps(&steps[0], 1000, lambda, random_engine);
+				DoNotOptimize(steps[0]);
+			}
+			state.SetItemsProcessed(state.GetIterations() * 1000);
+		});
+	}
+};
+
+static void RegisterObjectiveFunctions(BenchmarkRunner& runner)
+{
+	for (const ObjectiveFunction* function : { &sphere_function, &michaelwicz_function, &ackley_function,
+		&griewank_function, &rastrigin_function, &rosenbrock_function })
+	{
+		const ObjectiveFunction& func = *function;
+		const unsigned int dimensions = func.GetNumberOfDimensions();
+		Population points(BATCH_SIZE, dimensions);
+		RandomEngine random_engine(SEED);
+		for (unsigned int i = 0; i < BATCH_SIZE; ++i)
+		{
+			Population::GenerateSolution(points.GetSolution(i), func.GetBounds(), random_engine);
+		}
+
+		runner.Register(func.GetName() + "/point", [func, points](BenchmarkState& state)
+		{
+			unsigned int i = 0;
+			while (state.KeepRunning())
+			{
+				DoNotOptimize(func(points.GetSolution(i)));
+				i = (i + 1) % BATCH_SIZE;
+			}
+			state.SetItemsProcessed(state.GetIterations());
+		});
+		runner.Register(func.GetName() + "/batch:" + std::to_string(BATCH_SIZE), [func, points](BenchmarkState& state)
+		{
+			std::vector<double> fitness(BATCH_SIZE);
+			while (state.KeepRunning())
+			{
+				func.Evaluate(points.GetSolution(0), BATCH_SIZE, points.GetStride(), &fitness[0]);
+				DoNotOptimize(fitness[0]);
+			}
+			state.SetItemsProcessed(state.GetIterations() * BATCH_SIZE);
+		});
+	}
+};
+
+static void RegisterNest(BenchmarkRunner& runner)
+{
+	for (const ObjectiveFunction* function : { &rastrigin_function, &sphere_function })
+	{
+		const ObjectiveFunction& func = *function;
+		runner.Register("Nest::Nest/" + func.GetName(), [func](BenchmarkState& state)
+		{
+			RandomEngine random_engine(SEED);
+			while (state.KeepRunning())
+			{
+				Nest nest(func, random_engine);
+				DoNotOptimize(nest.GetFitness());
+			}
+		});
+		runner.Register("Nest::Copy/" + func.GetName(), [func](BenchmarkState& state)
+		{
+			RandomEngine random_engine(SEED);
+			const Nest nest(func, random_engine);
+			while (state.KeepRunning())
+			{
+				Nest copy(nest);
+				DoNotOptimize(copy.GetFitness());
+			}
+		});
+		runner.Register("Nest::Assign/" + func.GetName(), [func](BenchmarkState& state)
+		{
+			RandomEngine random_engine(SEED);
+			const Nest nest(func, random_engine);
+			Nest copy;
+			while (state.KeepRunning())
+			{
+				copy.Assign(&nest.GetSolutionsRef()[0], func.GetNumberOfDimensions(), nest.GetFitness(), nest.GetLambda());
+				DoNotOptimize(copy.GetFitness());
+			}
+		});
+	}
+};
+
+static void RegisterGenerationSteps(BenchmarkRunner& runner)
+{
+	for (unsigned int nests : { 25u, 100u, 400u })
+	{
+		//Ranking after change of fitness of 10% (incremental update) and all nests (full sort)
+		for (unsigned int percent : { 10u, 100u })
+		{
+			runner.Register("RankNests/nests:" + std::to_string(nests) + "/changed:" + std::to_string(percent) + "%",
+				[nests, percent](BenchmarkState& state)
+			{
+				BenchmarkSearch search(rastrigin_function, nests);
+				search.StartMin();
+				RandomEngine random_engine(SEED);
+				const unsigned int changed = std::max(1u, nests * percent / 100);
+				while (state.KeepRunning())
+				{
+					state.PauseTiming();
+					search.ChangeFitness(changed, random_engine);
+					state.ResumeTiming();
+					search.RankNests();
+				}
+				state.SetItemsProcessed(state.GetIterations() * nests);
+			});
+		}
+		runner.Register("AbandonNests/nests:" + std::to_string(nests), [nests](BenchmarkState& state)
+		{
+			BenchmarkSearch search(rastrigin_function, nests);
+			search.SetNumberOfThreads(1);
+			search.StartMin();
+			while (state.KeepRunning())
+			{
+				search.AbandonNests();
+				state.PauseTiming();
+				search.RankNests();
+				state.ResumeTiming();
+			}
+			state.SetItemsProcessed(state.GetIterations() * nests);
+		});
+	}
+};
+
+static void RegisterGeneration(BenchmarkRunner& runner)
+{
+	std::vector<unsigned int> threads = { 1 };
+	if (std::thread::hardware_concurrency() > 1)
+	{
+		threads.push_back(std::thread::hardware_concurrency());
+	}
+	for (const ObjectiveFunction* function : { &rastrigin_function, &sphere_function })
+	{
+		for (unsigned int nests : { 25u, 100u, 400u })
+		{
+			for (unsigned int thread_count : threads)
+			{
+				const ObjectiveFunction& func = *function;
+				runner.Register("Generation/" + func.GetName() + "/nests:" + std::to_string(nests) + "/threads:" + std::to_string(thread_count),
+					[func, nests, thread_count](BenchmarkState& state)
+				{
+					BenchmarkSearch search(func, nests);
+					search.SetNumberOfThreads(thread_count);
+					search.StartMin();
+					while (state.KeepRunning())
+					{
+						search.NextGeneration();
+					}
+					DoNotOptimize(search.GetCurrentBestValue());
+					state.SetItemsProcessed(state.GetIterations() * nests);
+				});
+			}
+		}
+	}
+};
+
+int main(int argc, char* argv[])
+{
+	BenchmarkRunner runner;
+	std::string filter;
+	std::string json_path;
+	std::string baseline_path;
+	double threshold = 0.1;
+	for (int i = 1; i < argc; ++i)
+	{
+		const std::string option = argv[i];
+		if (i + 1 == argc)
+		{
+			std::cerr << "Option " << option << " has no value\n";
+			return 2;
+		}
+		const std::string value = argv[++i];
+		if (option == "--filter")
+			filter = value;
+		else if (option == "--min-time")
+			runner.SetMinTime(std::atof(value.c_str()));
+		else if (option == "--repetitions")
+			runner.SetRepetitions(static_cast<unsigned int>(std::atoi(value.c_str())));
+		else if (option == "--json")
+			json_path = value;
+		else if (option == "--baseline")
+			baseline_path = value;
+		else if (option == "--threshold")
+			threshold = std::atof(value.c_str());
+		else
+		{
+			std::cerr << "Unknown option " << option << "\n";
+			return 2;
+		}
+	}
+
+	const char* instruction_set = KernelDispatch::GetName(KernelDispatch::GetInstructionSet());
+	std::cout << "Instruction set of kernels: " << instruction_set << "\n";
+	runner.AddContext("instruction_set", instruction_set);
+
+	RegisterLevyFlight(runner);
+	RegisterObjectiveFunctions(runner);
+	RegisterNest(runner);
+	RegisterGenerationSteps(runner);
+	RegisterGeneration(runner);
+
+	try
+	{
+		runner.Run(filter);
+		if (!json_path.empty())
+		{
+			std::ofstream file(json_path);
+			runner.WriteJson(file);
+		}
+		if (!baseline_path.empty())
+		{
+			bool is_regression = false;
+			std::cout << "\nComparison with " << baseline_path << ":\n" << std::fixed << std::setprecision(1);
+			for (const BenchmarkComparison& comparison : runner.Compare(baseline_path, threshold))
+			{
+				std::cout << comparison.name << ": " << comparison.baseline_nanoseconds << " -> " << comparison.nanoseconds <<
+					" ns (" << (comparison.change >= 0 ? "+" : "") << comparison.change * 100.0 << "%)" <<
+					(comparison.is_regression ? " REGRESSION" : "") << "\n";
+				is_regression = is_regression || comparison.is_regression;
+			}
+			return is_regression ? 1 : 0;
+		}
+	}
+	catch (std::exception& e)
+	{
+		std::cerr << e.what();
+		return 2;
+	}
+	return 0;
+};
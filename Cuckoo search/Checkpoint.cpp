@@ -0,0 +1,198 @@
+#include "Checkpoint.h"
+
+#include <fstream>
+#include <stdexcept>
+#include <cstdio>
+#include <cstring>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+static const char CHECKPOINT_MAGIC[8] = { 'C', 'S', 'C', 'H', 'E', 'C', 'K', '2' };
+
+template <typename T>
+static void WriteValue(std::ofstream& file, const T& value)
+{
+	file.write(reinterpret_cast<const char*>(&value), sizeof(value));
+};
+
+template <typename T>
+static void WriteVector(std::ofstream& file, const std::vector<T>& values)
+{
+	const std::uint64_t size = values.size();
+	WriteValue(file, size);
+	file.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(T));
+};
+
+template <typename T>
+static void ReadValue(std::ifstream& file, T& value)
+{
+	if (!file.read(reinterpret_cast<char*>(&value), sizeof(value)))
+		throw std::runtime_error("Checkpoint is truncated\n");
+};
+
+template <typename T>
+static void ReadVector(std::ifstream& file, std::vector<T>& values)
+{
+	std::uint64_t size;
+	ReadValue(file, size);
+	values.resize(static_cast<size_t>(size));
+	if (!file.read(reinterpret_cast<char*>(values.data()), values.size() * sizeof(T)))
+		throw std::runtime_error("Checkpoint is truncated\n");
+};
+
+static void ReplaceFile(const std::string& from, const std::string& to)
+{
+#ifdef _WIN32
+	if (!MoveFileExA(from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH))
+		throw std::runtime_error("Can't replace checkpoint " + to + "\n");
+#else
+	if (std::rename(from.c_str(), to.c_str()) != 0)
+		throw std::runtime_error("Can't replace checkpoint " + to + "\n");
+#endif
+};
+
+void WriteCheckpoint(const std::string& file_path, const SearchCheckpoint& checkpoint)
+{
+	const std::string temporary_path = file_path + ".tmp";
+	{
+		std::ofstream file(temporary_path, std::ios_base::binary);
+		if (!file)
+			throw std::runtime_error("Can't create checkpoint " + temporary_path + "\n");
+		file.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+		WriteValue(file, checkpoint.nests);
+		WriteValue(file, checkpoint.dimensions);
+		WriteValue(file, checkpoint.generation);
+		WriteValue(file, checkpoint.max_generations);
+		WriteValue(file, checkpoint.flight_block_size);
+		WriteValue(file, static_cast<std::uint8_t>(checkpoint.minimize));
+		WriteValue(file, static_cast<std::uint8_t>(checkpoint.lazy_cuckoo));
+		WriteValue(file, checkpoint.seed);
+		WriteValue(file, checkpoint.evaluations);
+		WriteValue(file, checkpoint.elapsed_seconds);
+		WriteValue(file, checkpoint.stagnation);
+		WriteValue(file, checkpoint.stagnation_best);
+		WriteVector(file, checkpoint.solutions);
+		WriteVector(file, checkpoint.fitness);
+		WriteVector(file, checkpoint.lambda);
+		WriteVector(file, checkpoint.order);
+		WriteVector(file, checkpoint.best_solution);
+		WriteValue(file, checkpoint.best_fitness);
+		WriteValue(file, checkpoint.best_lambda);
+		file.flush();
+		if (!file)
+			throw std::runtime_error("Can't write checkpoint " + temporary_path + "\n");
+	}
+	ReplaceFile(temporary_path, file_path);
+};
+
+SearchCheckpoint ReadCheckpoint(const std::string& file_path)
+{
+	std::ifstream file(file_path, std::ios_base::binary);
+	if (!file)
+		throw std::runtime_error("Can't open checkpoint " + file_path + "\n");
+
+	char magic[sizeof(CHECKPOINT_MAGIC)];
+	ReadValue(file, magic);
+	if (std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)) != 0)
+		throw std::runtime_error(file_path + " isn't checkpoint of search\n");
+
+	SearchCheckpoint checkpoint;
+	std::uint8_t flag;
+	ReadValue(file, checkpoint.nests);
+	ReadValue(file, checkpoint.dimensions);
+	ReadValue(file, checkpoint.generation);
+	ReadValue(file, checkpoint.max_generations);
+	ReadValue(file, checkpoint.flight_block_size);
+	ReadValue(file, flag);
+	checkpoint.minimize = (flag != 0);
+	ReadValue(file, flag);
+	checkpoint.lazy_cuckoo = (flag != 0);
+	ReadValue(file, checkpoint.seed);
+	ReadValue(file, checkpoint.evaluations);
+	ReadValue(file, checkpoint.elapsed_seconds);
+	ReadValue(file, checkpoint.stagnation);
+	ReadValue(file, checkpoint.stagnation_best);
+	ReadVector(file, checkpoint.solutions);
+	ReadVector(file, checkpoint.fitness);
+	ReadVector(file, checkpoint.lambda);
+	ReadVector(file, checkpoint.order);
+	ReadVector(file, checkpoint.best_solution);
+	ReadValue(file, checkpoint.best_fitness);
+	ReadValue(file, checkpoint.best_lambda);
+
+	if (checkpoint.solutions.size() != size_t(checkpoint.nests) * checkpoint.dimensions ||
+		checkpoint.fitness.size() != checkpoint.nests || checkpoint.lambda.size() != checkpoint.nests ||
+		checkpoint.order.size() != checkpoint.nests ||
+		checkpoint.best_solution.size() != checkpoint.dimensions)
+		throw std::runtime_error(file_path + " is damaged\n");
+	return checkpoint;
+};
+
+CheckpointWriter::CheckpointWriter(const std::string& file_path) :
+	m_file_path(file_path), m_writing(false), m_stop(false)
+{
+	m_thread = std::thread(&CheckpointWriter::WriterLoop, this);
+};
+
+CheckpointWriter::~CheckpointWriter()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_ready.notify_all();
+	m_thread.join();
+};
+
+void CheckpointWriter::Write(std::unique_ptr<SearchCheckpoint> checkpoint)
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pending = std::move(checkpoint);
+	}
+	m_ready.notify_one();
+};
+
+void CheckpointWriter::Wait()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_done.wait(lock, [&]() { return !m_pending && !m_writing; });
+	if (m_error)
+	{
+		const std::exception_ptr error = m_error;
+		m_error = nullptr;
+		std::rethrow_exception(error);
+	}
+};
+
+void CheckpointWriter::WriterLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		//Pending checkpoint is written before stop
+		m_ready.wait(lock, [&]() { return m_stop || m_pending; });
+		if (!m_pending)
+			return;
+
+		std::unique_ptr<SearchCheckpoint> checkpoint = std::move(m_pending);
+		m_writing = true;
+		lock.unlock();
+		try
+		{
+			WriteCheckpoint(m_file_path, *checkpoint);
+		}
+		catch (...)
+		{
+			lock.lock();
+			m_error = std::current_exception();
+			lock.unlock();
+		}
+		lock.lock();
+		m_writing = false;
+		m_done.notify_all();
+	}
+};
@@ -0,0 +1,83 @@
+/*
+	Description:
+		Checkpoint of search: full state, which is needed to continue search
+		(population, best ever nest, generation, counters of budget and seed).
+		Random streams of search depend only on (seed, generation, phase, index),
+		so search resumed from checkpoint gives the same result as search without break.
+		WriteCheckpoint writes temporary file and renames it, so file
+		with checkpoint is always complete.
+		CheckpointWriter writes checkpoints on background thread: search only copies
+		its state, if previous checkpoint is still writing, newer checkpoint replaces
+		waiting one.
+*/
+
+#ifndef CHECKPOINT
+#define CHECKPOINT
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#include <exception>
+
+struct SearchCheckpoint
+{
+	std::uint32_t		nests;
+	std::uint32_t		dimensions;
+	std::uint32_t		generation;
+	std::uint32_t		max_generations;
+	std::uint32_t		flight_block_size;
+	bool				minimize;
+	bool				lazy_cuckoo;
+	std::uint64_t		seed;
+	std::uint64_t		evaluations;
+	double				elapsed_seconds;
+	std::uint32_t		stagnation;
+	double				stagnation_best;
+	//Row-major matrix: nests x dimensions
+	std::vector<double>	solutions;
+	std::vector<double>	fitness;
+	std::vector<double>	lambda;
+	//Ranking of nests: order[rank] - index of nest
+	std::vector<std::uint32_t>	order;
+	std::vector<double>	best_solution;
+	double				best_fitness;
+	double				best_lambda;
+};
+
+void WriteCheckpoint(const std::string& file_path, const SearchCheckpoint& checkpoint);
+SearchCheckpoint ReadCheckpoint(const std::string& file_path);
+
+class CheckpointWriter
+{
+public:
+	CheckpointWriter(const std::string& file_path);
+	~CheckpointWriter();
+
+	//Checkpoint is written later on writer thread
+	void Write(std::unique_ptr<SearchCheckpoint> checkpoint);
+	//Waits until all checkpoints are written, rethrows error of writing
+	void Wait();
+	inline const std::string& GetFilePath() const { return m_file_path; };
+
+private:
+	std::string							m_file_path;
+	std::unique_ptr<SearchCheckpoint>	m_pending;
+	bool								m_writing;
+	bool								m_stop;
+	std::exception_ptr					m_error;
+	std::mutex							m_mutex;
+	std::condition_variable				m_ready;
+	std::condition_variable				m_done;
+	std::thread							m_thread;
+
+	CheckpointWriter(const CheckpointWriter&) = delete;
+	CheckpointWriter& operator=(const CheckpointWriter&) = delete;
+
+	void WriterLoop();
+};
+
+#endif // !CHECKPOINT
@@ -0,0 +1,234 @@
+#include "Constraints.h"
+
+#include <cmath>
+#include <stdexcept>
+
+const double ConstraintSet::INFEASIBLE_FITNESS = 1e300;
+
+ConstraintSet::ConstraintSet(ConstraintHandling handling) :
+	m_handling(handling), m_penalty(1e6), m_bounds_repair(BoundsRepair::CLAMP), m_projection_iterations(10)
+{
+};
+
+void ConstraintSet::AddLinearInequality(const std::vector<double>& coefficients, double bound)
+{
+	double norm = 0.0;
+	for (double coefficient : coefficients)
+	{
+		norm += coefficient * coefficient;
+	}
+	if (norm == 0.0)
+		throw std::runtime_error("Coefficients of linear constraint are zero\n");
+	m_linear_coefficients.push_back(coefficients);
+	m_linear_bounds.push_back(bound);
+	m_linear_norms.push_back(norm);
+};
+
+void ConstraintSet::AddInequality(ConstraintFunction constraint)
+{
+	m_inequalities.push_back(constraint);
+};
+
+void ConstraintSet::AddEquality(ConstraintFunction constraint, double tolerance)
+{
+	m_equalities.push_back(constraint);
+	m_equality_tolerances.push_back(tolerance);
+};
+
+double ConstraintSet::GetLinearViolation(const double* point, unsigned int dimensions) const
+{
+	double violation = 0.0;
+	for (size_t i = 0; i < m_linear_bounds.size(); ++i)
+	{
+		const std::vector<double>& coefficients = m_linear_coefficients[i];
+		if (coefficients.size() != dimensions)
+			throw std::runtime_error("Dimensions of linear constraint and point aren't equal\n");
+		double value = -m_linear_bounds[i];
+		for (unsigned int j = 0; j < dimensions; ++j)
+		{
+			value += coefficients[j] * point[j];
+		}
+		violation += std::max(0.0, value);
+	}
+	return violation;
+};
+
+double ConstraintSet::GetViolation(const double* point, unsigned int dimensions) const
+{
+	double violation = GetLinearViolation(point, dimensions);
+	for (const ConstraintFunction& constraint : m_inequalities)
+	{
+		violation += std::max(0.0, constraint(point, dimensions));
+	}
+	for (size_t i = 0; i < m_equalities.size(); ++i)
+	{
+		violation += std::max(0.0, std::fabs(m_equalities[i](point, dimensions)) - m_equality_tolerances[i]);
+	}
+	return violation;
+};
+
+double ConstraintSet::RepairCoordinate(double value, const Bounds& bounds) const
+{
+	if (m_bounds_repair == BoundsRepair::REFLECTION)
+	{
+		//Flight, which crosses bound, continues back into bounds
+		if (value < bounds.lower_bound)
+		{
+			value = 2.0 * bounds.lower_bound - value;
+		}
+		else if (value > bounds.upper_bound)
+		{
+			value = 2.0 * bounds.upper_bound - value;
+		}
+	}
+	//Reflection of very long flight can cross the other bound
+	return std::min(std::max(value, bounds.lower_bound), bounds.upper_bound);
+};
+
+bool ConstraintSet::Repair(double* point, const std::vector<Bounds>& bounds) const
+{
+	const unsigned int dimensions = static_cast<unsigned int>(bounds.size());
+	bool is_changed = false;
+	for (unsigned int iteration = 0; iteration < m_projection_iterations; ++iteration)
+	{
+		//Cyclic projections onto violated half-spaces and onto bounds
+		bool is_violated = false;
+		for (size_t i = 0; i < m_linear_bounds.size(); ++i)
+		{
+			const std::vector<double>& coefficients = m_linear_coefficients[i];
+			if (coefficients.size() != dimensions)
+				throw std::runtime_error("Dimensions of linear constraint and point aren't equal\n");
+			double value = -m_linear_bounds[i];
+			for (unsigned int j = 0; j < dimensions; ++j)
+			{
+				value += coefficients[j] * point[j];
+			}
+			if (value <= 0.0)
+				continue;
+			is_violated = true;
+			const double shift = value / m_linear_norms[i];
+			for (unsigned int j = 0; j < dimensions; ++j)
+			{
+				point[j] -= shift * coefficients[j];
+			}
+		}
+		if (!is_violated)
+			break;
+		is_changed = true;
+		for (unsigned int j = 0; j < dimensions; ++j)
+		{
+			point[j] = std::min(std::max(point[j], bounds[j].lower_bound), bounds[j].upper_bound);
+		}
+	}
+	return is_changed;
+};
+
+double ConstraintSet::GetInfeasibleFitness(double violation, bool minimize) const
+{
+	//Monotonic map of violation into [INFEASIBLE_FITNESS, 2 * INFEASIBLE_FITNESS)
+	const double fitness = INFEASIBLE_FITNESS * (2.0 - 1.0 / (1.0 + violation));
+	return minimize ? fitness : -fitness;
+};
+
+bool ConstraintSet::IsFeasibleFitness(double fitness)
+{
+	return std::fabs(fitness) < INFEASIBLE_FITNESS;
+};
+
+double ConstraintSet::GetFitnessViolation(double fitness)
+{
+	if (IsFeasibleFitness(fitness))
+		return 0.0;
+	return 1.0 / (2.0 - std::fabs(fitness) / INFEASIBLE_FITNESS) - 1.0;
+};
+
+ObjectiveFunction ConstraintSet::Wrap(const ObjectiveFunction& objective, bool minimize) const
+{
+	std::shared_ptr<const ConstraintSet> constraints = std::make_shared<ConstraintSet>(*this);
+	const double sign = minimize ? 1.0 : -1.0;
+
+	ObjectiveFunction function(BatchFunction(
+		[objective, constraints, minimize, sign](const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness)
+	{
+		if (constraints->m_handling == ConstraintHandling::PENALTY)
+		{
+			static thread_local std::vector<double> violations;
+			violations.resize(count);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				violations[i] = constraints->GetViolation(points + size_t(i) * stride, dimensions);
+			}
+			objective.Evaluate(points, count, stride, fitness);
+			for (unsigned int i = 0; i < count; ++i)
+			{
+				fitness[i] += sign * constraints->m_penalty * violations[i];
+			}
+			return;
+		}
+
+		//Violations are kept in fitness, objective is evaluated for blocks of feasible rows
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			fitness[i] = constraints->GetViolation(points + size_t(i) * stride, dimensions);
+		}
+		for (unsigned int first = 0; first < count;)
+		{
+			if (fitness[first] > 0.0)
+			{
+				fitness[first] = constraints->GetInfeasibleFitness(fitness[first], minimize);
+				++first;
+				continue;
+			}
+			unsigned int last = first + 1;
+			while (last < count && fitness[last] == 0.0)
+			{
+				++last;
+			}
+			objective.Evaluate(points + size_t(first) * stride, last - first, stride, fitness + first);
+			first = last;
+		}
+	}), objective.GetNumberOfDimensions(), objective.GetBounds(), objective.GetName());
+
+	if (objective.HasIncrementalFunction())
+	{
+		function.SetIncrementalFunction([objective, constraints, minimize, sign](const double* point, const double* previous_point,
+			double previous_fitness, const unsigned int* changed, unsigned int count)
+		{
+			const unsigned int dimensions = objective.GetNumberOfDimensions();
+			const double violation = constraints->GetViolation(point, dimensions);
+			if (constraints->m_handling == ConstraintHandling::PENALTY)
+			{
+				//Fitness of previous point has its penalty
+				const double previous_objective = previous_fitness - sign * constraints->m_penalty * constraints->GetViolation(previous_point, dimensions);
+				return objective.EvaluateChange(point, previous_point, previous_objective, changed, count) + sign * constraints->m_penalty * violation;
+			}
+			if (violation > 0.0)
+				return constraints->GetInfeasibleFitness(violation, minimize);
+			//Infeasible previous point doesn't have objective
+			if (!IsFeasibleFitness(previous_fitness))
+				return objective(point);
+			return objective.EvaluateChange(point, previous_point, previous_fitness, changed, count);
+		});
+	}
+	return function;
+};
+
+CompareFitness ConstraintSet::GetCompareFitness(bool minimize) const
+{
+	if (m_handling == ConstraintHandling::PENALTY)
+	{
+		if (minimize)
+			return [](double ls, double rs) { return ls < rs; };
+		return [](double ls, double rs) { return ls > rs; };
+	}
+	return [minimize](double ls, double rs)
+	{
+		const bool is_ls_feasible = IsFeasibleFitness(ls);
+		const bool is_rs_feasible = IsFeasibleFitness(rs);
+		if (is_ls_feasible != is_rs_feasible)
+			return is_ls_feasible;
+		if (!is_ls_feasible)
+			return GetFitnessViolation(ls) < GetFitnessViolation(rs);
+		return minimize ? ls < rs : ls > rs;
+	};
+};
@@ -0,0 +1,102 @@
+/*
+	Description:
+		Constraints of search besides bounds: linear inequalities a * x <= b,
+		nonlinear inequalities g(x) <= 0 and equalities |h(x)| <= tolerance.
+		Violation of point is sum of violations of constraints (0 - feasible point),
+		linear constraints are checked first, they are the cheapest.
+		Violation is checked before objective, so with feasibility rule
+		objective is evaluated only for feasible points:
+		feasibility rule - feasible point is better than infeasible one, infeasible points
+		are compared by violation, feasible points are compared by objective.
+		Fitness of infeasible point keeps its violation: +-INFEASIBLE_FITNESS * (2 - 1 / (1 + violation)),
+		it's worse than fitness of any feasible point (absolute value of objective has to be
+		less than INFEASIBLE_FITNESS), so usual comparisons of fitness follow feasibility rule.
+		penalty - objective is evaluated for all points, fitness is objective +- penalty * violation.
+		Repair of flights: coordinates out of bounds are clamped or reflected from bound,
+		after that point is projected onto violated linear constraints (cyclic projections),
+		so flights and new nests stay in feasible region of linear constraints.
+*/
+
+#ifndef CONSTRAINTS
+#define CONSTRAINTS
+
+#include "FunctionHelper.h"
+#include "Nest.h"
+
+#include <vector>
+#include <functional>
+#include <memory>
+
+enum class ConstraintHandling
+{
+	FEASIBILITY_RULE,
+	PENALTY
+};
+
+enum class BoundsRepair
+{
+	CLAMP,
+	REFLECTION
+};
+
+//Value of constraint: g(x) for inequality g(x) <= 0, h(x) for equality h(x) = 0
+using ConstraintFunction = std::function<double(const double* point, unsigned int dimensions)>;
+
+class ConstraintSet
+{
+public:
+	ConstraintSet(ConstraintHandling handling = ConstraintHandling::FEASIBILITY_RULE);
+
+	//coefficients * x <= bound
+	void AddLinearInequality(const std::vector<double>& coefficients, double bound);
+	//constraint(x) <= 0
+	void AddInequality(ConstraintFunction constraint);
+	//|constraint(x)| <= tolerance
+	void AddEquality(ConstraintFunction constraint, double tolerance = 1e-6);
+
+	//Sum of violations of all constraints, 0 - point is feasible
+	double GetViolation(const double* point, unsigned int dimensions) const;
+	//Repairs point by bounds and projections onto linear constraints, returns true if point is changed
+	bool Repair(double* point, const std::vector<Bounds>& bounds) const;
+	//Value, which is moved into bounds by repair of bounds
+	double RepairCoordinate(double value, const Bounds& bounds) const;
+
+	//Objective with checks of constraints, fitness of infeasible points depends on handling
+	ObjectiveFunction Wrap(const ObjectiveFunction& objective, bool minimize) const;
+	CompareFitness GetCompareFitness(bool minimize) const;
+	//Fitness of feasibility rule is feasible or keeps violation
+	static bool IsFeasibleFitness(double fitness);
+	static double GetFitnessViolation(double fitness);
+
+	inline void SetPenalty(double penalty) { m_penalty = penalty; };
+	inline void SetBoundsRepair(BoundsRepair repair) { m_bounds_repair = repair; };
+	//iterations = 0 - without projections
+	inline void SetProjectionIterations(unsigned int iterations) { m_projection_iterations = iterations; };
+
+	inline ConstraintHandling GetHandling() const { return m_handling; };
+	inline double GetPenalty() const { return m_penalty; };
+	inline BoundsRepair GetBoundsRepair() const { return m_bounds_repair; };
+	inline unsigned int GetProjectionIterations() const { return m_projection_iterations; };
+	inline bool IsEmpty() const { return m_linear_bounds.empty() && m_inequalities.empty() && m_equalities.empty(); };
+
+	static const double INFEASIBLE_FITNESS;
+
+private:
+	ConstraintHandling				m_handling;
+	double							m_penalty;
+	BoundsRepair					m_bounds_repair;
+	unsigned int					m_projection_iterations;
+	//Row-major matrix of linear constraints
+	std::vector<std::vector<double>>	m_linear_coefficients;
+	std::vector<double>				m_linear_bounds;
+	//Squared norms of rows for projections
+	std::vector<double>				m_linear_norms;
+	std::vector<ConstraintFunction>	m_inequalities;
+	std::vector<ConstraintFunction>	m_equalities;
+	std::vector<double>				m_equality_tolerances;
+
+	double GetLinearViolation(const double* point, unsigned int dimensions) const;
+	double GetInfeasibleFitness(double violation, bool minimize) const;
+};
+
+#endif // !CONSTRAINTS
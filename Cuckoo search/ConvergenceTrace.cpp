@@ -0,0 +1,322 @@
+#include "ConvergenceTrace.h"
+
+#include <stdexcept>
+#include <cstring>
+#include <iomanip>
+#include <algorithm>
+
+static const char TRACE_MAGIC[8] = { 'C', 'S', 'T', 'R', 'A', 'C', 'E', '1' };
+
+static void WriteValue(std::vector<std::uint8_t>& buffer, const void* value, size_t size)
+{
+	const std::uint8_t* bytes = static_cast<const std::uint8_t*>(value);
+	buffer.insert(buffer.end(), bytes, bytes + size);
+};
+
+static void WriteVarint(std::vector<std::uint8_t>& buffer, std::uint64_t value)
+{
+	while (value >= 0x80)
+	{
+		buffer.push_back(static_cast<std::uint8_t>(value | 0x80));
+		value >>= 7;
+	}
+	buffer.push_back(static_cast<std::uint8_t>(value));
+};
+
+static std::uint64_t GetBits(double value)
+{
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+};
+
+static double FromBits(std::uint64_t bits)
+{
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+};
+
+static void WriteColumn(std::vector<std::uint8_t>& buffer, const double* column, size_t size, TraceCompression compression)
+{
+	if (compression == TraceCompression::NONE)
+	{
+		WriteValue(buffer, column, size * sizeof(double));
+		return;
+	}
+	std::uint64_t previous = 0;
+	for (size_t i = 0; i < size; ++i)
+	{
+		const std::uint64_t bits = GetBits(column[i]);
+		WriteVarint(buffer, bits ^ previous);
+		previous = bits;
+	}
+};
+
+class TraceInput
+{
+public:
+	TraceInput(const std::vector<std::uint8_t>& data) :
+		m_data(data), m_position(0) {};
+
+	inline bool IsEnd() const { return m_position >= m_data.size(); };
+
+	void Read(void* value, size_t size)
+	{
+		if (m_position + size > m_data.size())
+			throw std::runtime_error("Trace is truncated\n");
+		std::memcpy(value, &m_data[m_position], size);
+		m_position += size;
+	};
+
+	std::uint64_t ReadVarint()
+	{
+		std::uint64_t value = 0;
+		for (unsigned int shift = 0; shift < 64; shift += 7)
+		{
+			std::uint8_t byte;
+			Read(&byte, 1);
+			value |= std::uint64_t(byte & 0x7F) << shift;
+			if ((byte & 0x80) == 0)
+				return value;
+		}
+		throw std::runtime_error("Trace has wrong varint\n");
+	};
+
+	void ReadColumn(double* column, size_t size, TraceCompression compression)
+	{
+		if (compression == TraceCompression::NONE)
+		{
+			Read(column, size * sizeof(double));
+			return;
+		}
+		std::uint64_t previous = 0;
+		for (size_t i = 0; i < size; ++i)
+		{
+			previous ^= ReadVarint();
+			column[i] = FromBits(previous);
+		}
+	};
+
+private:
+	const std::vector<std::uint8_t>&	m_data;
+	size_t								m_position;
+};
+
+TraceWriter::TraceWriter(const std::string& file_path, const TraceHeader& header) :
+	m_file(file_path, std::ios_base::binary), m_header(header)
+{
+	if (!m_file)
+		throw std::runtime_error("Can't create trace " + file_path + "\n");
+
+	m_generations.reserve(BLOCK_SIZE);
+	m_fitness.reserve(BLOCK_SIZE);
+	m_columns.resize(size_t(BLOCK_SIZE) * m_header.dimensions);
+
+	std::vector<std::uint8_t> buffer;
+	WriteValue(buffer, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+	const std::uint32_t name_size = static_cast<std::uint32_t>(header.function_name.size());
+	WriteValue(buffer, &name_size, sizeof(name_size));
+	WriteValue(buffer, header.function_name.data(), name_size);
+	WriteValue(buffer, &header.dimensions, sizeof(header.dimensions));
+	WriteValue(buffer, &header.nests, sizeof(header.nests));
+	WriteValue(buffer, &header.iterations, sizeof(header.iterations));
+	WriteValue(buffer, &header.min_lambda, sizeof(header.min_lambda));
+	WriteValue(buffer, &header.max_lambda, sizeof(header.max_lambda));
+	WriteValue(buffer, &header.min_step, sizeof(header.min_step));
+	WriteValue(buffer, &header.max_step, sizeof(header.max_step));
+	WriteValue(buffer, &header.probability, sizeof(header.probability));
+	const std::uint8_t lazy_cuckoo = header.lazy_cuckoo ? 1 : 0;
+	WriteValue(buffer, &lazy_cuckoo, sizeof(lazy_cuckoo));
+	WriteValue(buffer, &header.seed, sizeof(header.seed));
+	WriteValue(buffer, &header.test, sizeof(header.test));
+	WriteValue(buffer, &header.compression, sizeof(header.compression));
+	m_file.write(reinterpret_cast<const char*>(buffer.data()), buffer.size());
+};
+
+TraceWriter::~TraceWriter()
+{
+	Flush();
+};
+
+void TraceWriter::Append(std::uint32_t generation, double fitness, const double* solution)
+{
+	const size_t record = m_fitness.size();
+	m_generations.push_back(generation);
+	m_fitness.push_back(fitness);
+	for (std::uint32_t k = 0; k < m_header.dimensions; ++k)
+	{
+		m_columns[k * BLOCK_SIZE + record] = solution[k];
+	}
+	if (m_fitness.size() == BLOCK_SIZE)
+	{
+		Flush();
+	}
+};
+
+void TraceWriter::Flush()
+{
+	if (m_fitness.empty())
+		return;
+
+	//Block: records, payload size, payload
+	const std::uint32_t records = static_cast<std::uint32_t>(m_fitness.size());
+	m_buffer.clear();
+	if (m_header.compression == TraceCompression::NONE)
+	{
+		WriteValue(m_buffer, m_generations.data(), records * sizeof(std::uint32_t));
+	}
+	else
+	{
+		std::uint32_t previous = 0;
+		for (std::uint32_t generation : m_generations)
+		{
+			WriteVarint(m_buffer, generation - previous);
+			previous = generation;
+		}
+	}
+	WriteColumn(m_buffer, m_fitness.data(), records, m_header.compression);
+	for (std::uint32_t k = 0; k < m_header.dimensions; ++k)
+	{
+		WriteColumn(m_buffer, &m_columns[k * BLOCK_SIZE], records, m_header.compression);
+	}
+
+	const std::uint32_t payload_size = static_cast<std::uint32_t>(m_buffer.size());
+	m_file.write(reinterpret_cast<const char*>(&records), sizeof(records));
+	m_file.write(reinterpret_cast<const char*>(&payload_size), sizeof(payload_size));
+	m_file.write(reinterpret_cast<const char*>(m_buffer.data()), m_buffer.size());
+	m_file.flush();
+
+	m_generations.clear();
+	m_fitness.clear();
+};
+
+ConvergenceTrace ReadTrace(const std::string& file_path)
+{
+	std::ifstream file(file_path, std::ios_base::binary);
+	if (!file)
+		throw std::runtime_error("Can't open trace " + file_path + "\n");
+	const std::vector<std::uint8_t> data((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+	TraceInput input(data);
+
+	ConvergenceTrace trace;
+	TraceHeader& header = trace.header;
+	char magic[sizeof(TRACE_MAGIC)];
+	input.Read(magic, sizeof(magic));
+	if (std::memcmp(magic, TRACE_MAGIC, sizeof(magic)) != 0)
+		throw std::runtime_error(file_path + " isn't convergence trace\n");
+	std::uint32_t name_size;
+	input.Read(&name_size, sizeof(name_size));
+	header.function_name.resize(name_size);
+	input.Read(&header.function_name[0], name_size);
+	input.Read(&header.dimensions, sizeof(header.dimensions));
+	input.Read(&header.nests, sizeof(header.nests));
+	input.Read(&header.iterations, sizeof(header.iterations));
+	input.Read(&header.min_lambda, sizeof(header.min_lambda));
+	input.Read(&header.max_lambda, sizeof(header.max_lambda));
+	input.Read(&header.min_step, sizeof(header.min_step));
+	input.Read(&header.max_step, sizeof(header.max_step));
+	input.Read(&header.probability, sizeof(header.probability));
+	std::uint8_t lazy_cuckoo;
+	input.Read(&lazy_cuckoo, sizeof(lazy_cuckoo));
+	header.lazy_cuckoo = (lazy_cuckoo != 0);
+	input.Read(&header.seed, sizeof(header.seed));
+	input.Read(&header.test, sizeof(header.test));
+	input.Read(&header.compression, sizeof(header.compression));
+
+	std::vector<double> columns;
+	while (!input.IsEnd())
+	{
+		std::uint32_t records;
+		std::uint32_t payload_size;
+		input.Read(&records, sizeof(records));
+		input.Read(&payload_size, sizeof(payload_size));
+
+		const size_t first = trace.fitness.size();
+		trace.generations.resize(first + records);
+		trace.fitness.resize(first + records);
+		if (header.compression == TraceCompression::NONE)
+		{
+			input.Read(&trace.generations[first], records * sizeof(std::uint32_t));
+		}
+		else
+		{
+			std::uint32_t previous = 0;
+			for (std::uint32_t i = 0; i < records; ++i)
+			{
+				previous += static_cast<std::uint32_t>(input.ReadVarint());
+				trace.generations[first + i] = previous;
+			}
+		}
+		input.ReadColumn(&trace.fitness[first], records, header.compression);
+
+		columns.resize(size_t(records) * header.dimensions);
+		for (std::uint32_t k = 0; k < header.dimensions; ++k)
+		{
+			input.ReadColumn(&columns[size_t(k) * records], records, header.compression);
+		}
+		trace.solutions.resize((first + records) * header.dimensions);
+		for (std::uint32_t i = 0; i < records; ++i)
+		{
+			for (std::uint32_t k = 0; k < header.dimensions; ++k)
+			{
+				trace.solutions[(first + i) * header.dimensions + k] = columns[size_t(k) * records + i];
+			}
+		}
+	}
+	return trace;
+};
+
+ConvergenceTrace AverageTraces(const std::vector<ConvergenceTrace>& traces)
+{
+	ConvergenceTrace average;
+	if (traces.empty())
+		return average;
+
+	size_t size = traces[0].GetSize();
+	for (const ConvergenceTrace& trace : traces)
+	{
+		size = std::min(size, trace.GetSize());
+	}
+	average.header = traces[0].header;
+	average.generations.assign(traces[0].generations.begin(), traces[0].generations.begin() + size);
+	average.fitness.assign(size, 0.0);
+	average.solutions.assign(size * average.header.dimensions, 0.0);
+	for (const ConvergenceTrace& trace : traces)
+	{
+		for (size_t i = 0; i < size; ++i)
+		{
+			average.fitness[i] += trace.fitness[i] / double(traces.size());
+		}
+		for (size_t i = 0; i < average.solutions.size(); ++i)
+		{
+			average.solutions[i] += trace.solutions[i] / double(traces.size());
+		}
+	}
+	return average;
+};
+
+void ExportTextLog(const ConvergenceTrace& trace, std::ostream& o_stream)
+{
+	const std::uint32_t dimensions = trace.header.dimensions;
+	o_stream << std::fixed;
+	for (size_t i = 0; i < trace.GetSize(); ++i)
+	{
+		const double* solution = trace.GetSolution(i);
+		o_stream << "#" << (trace.generations[i] + 1) << " : Function value: " << std::setprecision(14) << trace.fitness[i];
+		for (std::uint32_t k = 0; k < dimensions; ++k)
+		{
+			o_stream << std::setprecision(5) << solution[k] << ", ";
+		}
+		o_stream << solution[dimensions - 1] << "]\n";
+	}
+};
+
+void ExportGrapherLog(const ConvergenceTrace& trace, std::ostream& o_stream, unsigned int points)
+{
+	const size_t step = std::max<size_t>(1, trace.GetSize() / std::max(1u, points));
+	for (size_t i = 0; i < trace.GetSize(); i += step)
+	{
+		o_stream << trace.generations[i] << " " << trace.fitness[i] << "\n";
+	}
+};
@@ -0,0 +1,89 @@
+/*
+	Description:
+		Binary convergence trace: best ever nest of each generation of one test.
+		File has fixed header (function, dimensions and parameters of search) and
+		blocks of records. Block is columnar: column of generations, column of fitness and
+		column for each coordinate. With DELTA compression generations are stored as
+		varint differences and doubles as varint of XOR with previous value of column,
+		so unchanged best nest takes one byte per column. Each block is independent,
+		so trace of interrupted run loses at most last block.
+		Fixed-size numbers (header, columns without compression) are stored in native byte order,
+		varints of DELTA compression don't depend on it.
+		TraceWriter writes trace during the run, ReadTrace reads whole trace,
+		Export functions regenerate text log and 4AdvancedGrapher formats.
+*/
+
+#ifndef CONVERGENCE_TRACE
+#define CONVERGENCE_TRACE
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <ostream>
+#include <cstdint>
+
+enum class TraceCompression : std::uint8_t { NONE = 0, DELTA = 1 };
+
+struct TraceHeader
+{
+	std::string			function_name;
+	std::uint32_t		dimensions;
+	std::uint32_t		nests;
+	std::uint32_t		iterations;
+	double				min_lambda;
+	double				max_lambda;
+	double				min_step;
+	double				max_step;
+	double				probability;
+	bool				lazy_cuckoo;
+	std::uint64_t		seed;
+	std::uint32_t		test;
+	TraceCompression	compression;
+};
+
+struct ConvergenceTrace
+{
+	TraceHeader					header;
+	std::vector<std::uint32_t>	generations;
+	std::vector<double>			fitness;
+	//Row-major matrix: generations x dimensions
+	std::vector<double>			solutions;
+
+	inline size_t GetSize() const { return fitness.size(); };
+	inline const double* GetSolution(size_t record) const { return &solutions[record * header.dimensions]; };
+};
+
+class TraceWriter
+{
+public:
+	static const unsigned int BLOCK_SIZE = 256;
+
+	TraceWriter(const std::string& file_path, const TraceHeader& header);
+	~TraceWriter();
+
+	void Append(std::uint32_t generation, double fitness, const double* solution);
+	//Writes buffered records to file
+	void Flush();
+
+private:
+	std::ofstream				m_file;
+	TraceHeader					m_header;
+	std::vector<std::uint32_t>	m_generations;
+	std::vector<double>			m_fitness;
+	//Column-major: coordinate k of record i is m_columns[k * BLOCK_SIZE + i]
+	std::vector<double>			m_columns;
+	std::vector<std::uint8_t>	m_buffer;
+
+	TraceWriter(const TraceWriter&) = delete;
+	TraceWriter& operator=(const TraceWriter&) = delete;
+};
+
+ConvergenceTrace ReadTrace(const std::string& file_path);
+//Element-wise average of traces (length of the shortest trace)
+ConvergenceTrace AverageTraces(const std::vector<ConvergenceTrace>& traces);
+//Text log: "#generation : Function value: fitness" and coordinates
+void ExportTextLog(const ConvergenceTrace& trace, std::ostream& o_stream);
+//4AdvancedGrapher: "generation fitness" for points generations
+void ExportGrapherLog(const ConvergenceTrace& trace, std::ostream& o_stream, unsigned int points);
+
+#endif // !CONVERGENCE_TRACE
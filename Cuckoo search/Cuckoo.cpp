@@ -1,18 +1,60 @@
 #include "Cuckoo.h"
+#include "Simd.h"
 
 //Standard fly
-Nest Cuckoo::MakeFlight(const Nest& nest)
+unsigned int Cuckoo::GenerateCandidates(const double* host, double lambda, const double* alpha,
+	const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* candidates, unsigned int, unsigned int* changed)
 {
-	Egg new_solution = GetNewSolution(nest);
-	return Nest(m_function, new_solution, nest.GetLambda());
+	const unsigned int count = GetNewSolution(host, lambda, alpha, random_engine, candidates, changed);
+	return BoundSolution(candidates, bounds, changed, count);
+};
+
+int Cuckoo::SelectCandidate(double, const double*, const CompareFitness&) const
+{
+	return 0;
+};
+
+double Cuckoo::MakeFlight(const double* host, double host_fitness, double lambda, const double* alpha,
+	const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* new_solution)
+{
+	static thread_local AlignedVector candidates;
+	static thread_local std::vector<double> candidates_fitness;
+	static thread_local std::vector<unsigned int> changed;
+	const unsigned int dimensions = m_function.GetNumberOfDimensions();
+	const unsigned int amount = GetNumberOfCandidates();
+	candidates.resize(size_t(amount) * dimensions);
+	candidates_fitness.resize(amount);
+	changed.resize(std::max(1u, GetSubspaceSize()));
+
+	const unsigned int count = GenerateCandidates(host, lambda, alpha, bounds, random_engine, &candidates[0], dimensions, &changed[0]);
+	if (count < dimensions && m_function.HasIncrementalFunction())
+	{
+		for (unsigned int i = 0; i < amount; ++i)
+		{
+			candidates_fitness[i] = m_function.EvaluateChange(&candidates[i * dimensions], host, host_fitness, &changed[0], count);
+		}
+	}
+	else
+	{
+		m_function.Evaluate(&candidates[0], amount, dimensions, &candidates_fitness[0]);
+	}
+	static const CompareFitness minimize = [](double ls, double rs) { return ls < rs; };
+	const int chosen = SelectCandidate(host_fitness, &candidates_fitness[0], minimize);
+	if (chosen == HOST_CANDIDATE)
+	{
+		std::copy(host, host + dimensions, new_solution);
+		return host_fitness;
+	}
+	std::copy(&candidates[chosen * dimensions], &candidates[chosen * dimensions] + dimensions, new_solution);
+	return candidates_fitness[chosen];
 };
 
 	//** THE BEST RESULT **//
 /*	Make fly, divide this path on 2 equal path and check 
 	3 points (start position, middle and end point), where solution is better	*/
-/*Nest Cuckoo::MakeFlight(const Nest& nest)
+/*Nest Cuckoo::MakeFlight(const Nest& nest, RandomEngine& random_engine)
 {
-	Egg new_solution = GetNewSolution(nest);
+	Egg new_solution = GetNewSolution(nest, random_engine);
 	Egg curr_best = new_solution;
 	Egg step = (new_solution - nest.GetSolutions()) / 2.0;
 	//#pragma omp parallel for
@@ -28,13 +70,13 @@ Nest Cuckoo::MakeFlight(const Nest& nest)
 	return Nest(m_function, curr_best, nest.GetLambda());
 };*/
 
-/*Nest Cuckoo::MakeFlight(const Nest& nest)
+/*Nest Cuckoo::MakeFlight(const Nest& nest, RandomEngine& random_engine)
 {
-	Egg curr_best = GetNewSolution(nest);
+	Egg curr_best = GetNewSolution(nest, random_engine);
 	double best_value = m_function(curr_best);
 	for (int i = 1; i < 10; ++i)
 	{
-		Egg new_solution = GetNewSolution(nest);
+		Egg new_solution = GetNewSolution(nest, random_engine);
 		if (m_function(new_solution) <= best_value)
 		{
 			best_value = m_function(new_solution);
@@ -43,47 +85,143 @@ Nest Cuckoo::MakeFlight(const Nest& nest)
 	}
 };*/
 
-Nest Cuckoo::MakeFlight(const Nest& nest, Bounds& bounds)
+Nest Cuckoo::MakeFlight(const Nest& nest, const Egg& alpha, RandomEngine& random_engine)
 {
-	Egg new_solution = GetNewSolution(nest);
-	return Nest(m_function, bounds, new_solution, nest.GetLambda());
+	std::vector<Bounds> bounds = m_function.GetBounds();
+	return MakeFlight(nest, alpha, bounds, random_engine);
 };
 
-Nest Cuckoo::MakeFlight(const Nest& nest, std::vector<Bounds>& bounds)
+Nest Cuckoo::MakeFlight(const Nest& nest, const Egg& alpha, Bounds& bounds, RandomEngine& random_engine)
 {
-	Egg new_solution = GetNewSolution(nest);
-	return Nest(m_function, bounds, new_solution, nest.GetLambda());
+	std::vector<Bounds> all_bounds(nest.GetSolutionsRef().size(), bounds);
+	return MakeFlight(nest, alpha, all_bounds, random_engine);
 };
 
-Egg Cuckoo::GetNewSolution(const Nest& nest)
+Nest Cuckoo::MakeFlight(const Nest& nest, const Egg& alpha, std::vector<Bounds>& bounds, RandomEngine& random_engine)
 {
-	std::valarray<double> old_solution = nest.GetSolutions();
-	return old_solution + nest.GetAlpha() * LevyFlight::GetValue(nest.GetLambda(), static_cast<unsigned int>(old_solution.size()));
+	Egg new_solution(nest.GetSolutionsRef().size());
+	const double fitness = MakeFlight(&nest.GetSolutionsRef()[0], nest.GetFitness(), nest.GetLambda(), &alpha[0],
+		bounds, random_engine, &new_solution[0]);
+	return Nest(new_solution, fitness, nest.GetLambda());
 };
 
-Nest LazyCuckoo::MakeFlight(const Nest &nest)
+unsigned int Cuckoo::GetNewSolution(const double* host, double lambda, const double* alpha, RandomEngine& random_engine,
+	double* new_solution, unsigned int* changed)
 {
-	Egg new_solution = GetNewSolution(nest);
-	Egg curr_best = new_solution;
-	Egg step = (new_solution - nest.GetSolutions()) / 2.0;
-	for (int i = 0; i < 2; ++i)
+	const unsigned int dimensions = m_function.GetNumberOfDimensions();
+	if (!IsSubspaceFlight())
 	{
-		new_solution -= step;
-		if (m_function(new_solution) < m_function(curr_best))
+		LevyFlight::FillSteps(new_solution, dimensions, lambda, random_engine);
+		CUCKOO_SIMD_LOOP
+		for (unsigned int i = 0; i < dimensions; ++i)
 		{
-			curr_best = new_solution;
+			new_solution[i] = host[i] + alpha[i] * new_solution[i];
 		}
+		return dimensions;
 	}
 
-	return Nest(m_function, curr_best, nest.GetLambda());
+	//Levy steps are generated only for changed coordinates
+	static thread_local AlignedVector steps;
+	const unsigned int count = ChooseSubspace(random_engine, changed);
+	steps.resize(count);
+	LevyFlight::FillSteps(&steps[0], count, lambda, random_engine);
+	std::copy(host, host + dimensions, new_solution);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int coordinate = changed[i];
+		new_solution[coordinate] = host[coordinate] + alpha[coordinate] * steps[i];
+	}
+	return count;
 };
 
-Nest LazyCuckoo::MakeFlight(const Nest & nest, Bounds & bounds)
+unsigned int Cuckoo::ChooseSubspace(RandomEngine& random_engine, unsigned int* changed) const
 {
-	return Nest();
+	const unsigned int dimensions = m_function.GetNumberOfDimensions();
+	const unsigned int blocks = (dimensions + m_subspace_block_size - 1) / m_subspace_block_size;
+	unsigned int count = 0;
+	for (unsigned int chosen = 0; chosen < m_subspace_blocks && chosen < blocks; ++chosen)
+	{
+		//Block is chosen again, if its first coordinate is already changed
+		unsigned int first;
+		do {
+			first = random_engine.UniformIndex(blocks) * m_subspace_block_size;
+		} while (std::find(changed, changed + count, first) != changed + count);
+
+		const unsigned int last = std::min(dimensions, first + m_subspace_block_size);
+		for (unsigned int coordinate = first; coordinate < last; ++coordinate)
+		{
+			changed[count++] = coordinate;
+		}
+	}
+	return count;
 };
 
-Nest LazyCuckoo::MakeFlight(const Nest & nest, std::vector<Bounds>& bounds)
+unsigned int Cuckoo::BoundSolution(double* solution, const std::vector<Bounds>& bounds, const unsigned int* changed, unsigned int count) const
 {
-	return Nest();
+	const unsigned int dimensions = m_function.GetNumberOfDimensions();
+	if (!m_constraints)
+	{
+		if (count == dimensions)
+		{
+			Population::BoundSolution(solution, bounds);
+			return count;
+		}
+		for (unsigned int i = 0; i < count; ++i)
+		{
+			const unsigned int coordinate = changed[i];
+			solution[coordinate] = std::min(std::max(solution[coordinate], bounds[coordinate].lower_bound), bounds[coordinate].upper_bound);
+		}
+		return count;
+	}
+
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int coordinate = (count == dimensions) ? i : changed[i];
+		solution[coordinate] = m_constraints->RepairCoordinate(solution[coordinate], bounds[coordinate]);
+	}
+	return m_constraints->Repair(solution, bounds) ? dimensions : count;
+};
+
+/*	Make fly and check 3 points: end of flight, middle of path and start position (host).
+	Candidates are end of flight and middle of path, host fitness is already known	*/
+unsigned int LazyCuckoo::GenerateCandidates(const double* host, double lambda, const double* alpha,
+	const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* candidates, unsigned int stride, unsigned int* changed)
+{
+	const unsigned int dimensions = m_function.GetNumberOfDimensions();
+	double* end = candidates;
+	double* middle = candidates + stride;
+
+	const unsigned int count = BoundSolution(end, bounds, changed, GetNewSolution(host, lambda, alpha, random_engine, end, changed));
+	if (count == dimensions)
+	{
+		CUCKOO_SIMD_LOOP
+		for (unsigned int i = 0; i < dimensions; ++i)
+		{
+			middle[i] = end[i] - (end[i] - host[i]) / 2.0;
+		}
+		return count;
+	}
+
+	//Middle of path differs from host only in changed coordinates too
+	std::copy(host, host + dimensions, middle);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const unsigned int coordinate = changed[i];
+		middle[coordinate] = end[coordinate] - (end[coordinate] - host[coordinate]) / 2.0;
+	}
+	return count;
 };
+
+int LazyCuckoo::SelectCandidate(double host_fitness, const double* candidates_fitness, const CompareFitness& cmp_fitness) const
+{
+	int best = 0;
+	if (cmp_fitness(candidates_fitness[1], candidates_fitness[best]))
+	{
+		best = 1;
+	}
+	if (cmp_fitness(host_fitness, candidates_fitness[best]))
+	{
+		best = HOST_CANDIDATE;
+	}
+	return best;
+};
\ No newline at end of file
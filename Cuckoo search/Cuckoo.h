@@ -1,6 +1,20 @@
 /*
 	Description:
 		This class gets nest (solution) and make flight via Levy Flights.
+		Flight is splitted into 3 stages, so search can evaluate flights of
+		all cuckoos by blocks:
+		GenerateCandidates - writes points, which have to be evaluated,
+		(search evaluates them by ObjectiveFunction::Evaluate),
+		SelectCandidate - chooses result of flight by fitness of candidates
+		(comparison of search, so it follows direction of search and constraints).
+		MakeFlight makes all stages for single host, Nest overloads are wrappers for it.
+		Subspace flight (SetSubspace) changes only few random blocks of coordinates:
+		coordinates are splitted into blocks of block_size, flight changes coordinates
+		of few different random blocks, other coordinates stay as in host.
+		Changed coordinates are returned, so candidates can be evaluated incrementally.
+		With constraints (SetConstraints) candidates are repaired: coordinates out of bounds
+		are clamped or reflected, point is projected onto linear constraints (projection
+		can change any coordinate, so such candidate is returned as full flight).
 */
 
 
@@ -10,27 +24,64 @@
 #include "LevyFlight.h"
 #include "FunctionHelper.h"
 #include "Nest.h"
+#include "Population.h"
+#include "Constraints.h"
+#include "Random.h"
 
 #include <valarray>
 #include <vector>
+#include <algorithm>
+#include <memory>
 
 
 class Cuckoo
 {
 public:
 	Cuckoo(ObjectiveFunction func) :
-		m_function(func) {};
-	virtual Nest MakeFlight(const Nest& nest);
-	virtual Nest MakeFlight(const Nest& nest, Bounds& bounds);
-	virtual Nest MakeFlight(const Nest& nest, std::vector<Bounds>& bounds);
+		m_function(func), m_subspace_block_size(0), m_subspace_blocks(1) {};
+	virtual ~Cuckoo() {};
+
+	//Number of points, which are evaluated for one flight
+	inline virtual unsigned int GetNumberOfCandidates() const { return 1; };
+	//Writes GetNumberOfCandidates() rows with stride into candidates and returns number of changed coordinates.
+	//Subspace flight writes changed coordinates into changed (GetSubspaceSize() entries),
+	//full flight changes all coordinates and doesn't use changed
+	virtual unsigned int GenerateCandidates(const double* host, double lambda, const double* alpha,
+		const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* candidates, unsigned int stride, unsigned int* changed);
+	//Returns index of chosen candidate or HOST_CANDIDATE if host stays better (fitness is compared by cmp_fitness of search)
+	virtual int SelectCandidate(double host_fitness, const double* candidates_fitness, const CompareFitness& cmp_fitness) const;
+
+	//Writes new solution of host into new_solution and returns its fitness (single flight minimizes fitness)
+	double MakeFlight(const double* host, double host_fitness, double lambda, const double* alpha,
+		const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* new_solution);
+
+	Nest MakeFlight(const Nest& nest, const Egg& alpha, RandomEngine& random_engine);
+	Nest MakeFlight(const Nest& nest, const Egg& alpha, Bounds& bounds, RandomEngine& random_engine);
+	Nest MakeFlight(const Nest& nest, const Egg& alpha, std::vector<Bounds>& bounds, RandomEngine& random_engine);
 
 	inline ObjectiveFunction GetFunction() const { return m_function; };
 	inline void SetFunction(ObjectiveFunction func) { m_function = func; };
+	//block_size = 0 - flights change all coordinates
+	inline void SetConstraints(std::shared_ptr<const ConstraintSet> constraints) { m_constraints = constraints; };
+	inline void SetSubspace(unsigned int block_size, unsigned int blocks = 1) { m_subspace_block_size = block_size; m_subspace_blocks = std::max(1u, blocks); };
+	inline bool IsSubspaceFlight() const { return m_subspace_block_size > 0 && m_subspace_block_size * m_subspace_blocks < m_function.GetNumberOfDimensions(); };
+	//Maximal number of coordinates changed by subspace flight (0 - flights change all coordinates)
+	inline unsigned int GetSubspaceSize() const { return IsSubspaceFlight() ? m_subspace_block_size * m_subspace_blocks : 0; };
+
+	static const int HOST_CANDIDATE = -1;
 	
 protected:
 	ObjectiveFunction m_function;
+	unsigned int m_subspace_block_size;
+	unsigned int m_subspace_blocks;
+	std::shared_ptr<const ConstraintSet> m_constraints;
 
-	Egg GetNewSolution(const Nest& nest);
+	//Returns number of changed coordinates, see GenerateCandidates
+	unsigned int GetNewSolution(const double* host, double lambda, const double* alpha, RandomEngine& random_engine,
+		double* new_solution, unsigned int* changed);
+	unsigned int ChooseSubspace(RandomEngine& random_engine, unsigned int* changed) const;
+	//Returns number of changed coordinates after repair (dimensions, if repair changed other coordinates)
+	unsigned int BoundSolution(double* solution, const std::vector<Bounds>& bounds, const unsigned int* changed, unsigned int count) const;
 };
 
 class LazyCuckoo : public Cuckoo
@@ -38,10 +89,10 @@ class LazyCuckoo : public Cuckoo
 public:
 	LazyCuckoo(ObjectiveFunction func) :
 		Cuckoo(func) {};
-	virtual Nest MakeFlight(const Nest& nest);
-	virtual Nest MakeFlight(const Nest& nest, Bounds& bounds);
-	virtual Nest MakeFlight(const Nest& nest, std::vector<Bounds>& bounds);
+	inline virtual unsigned int GetNumberOfCandidates() const { return 2; };
+	virtual unsigned int GenerateCandidates(const double* host, double lambda, const double* alpha,
+		const std::vector<Bounds>& bounds, RandomEngine& random_engine, double* candidates, unsigned int stride, unsigned int* changed);
+	virtual int SelectCandidate(double host_fitness, const double* candidates_fitness, const CompareFitness& cmp_fitness) const;
 };
 
 #endif // !CUCKOO
-
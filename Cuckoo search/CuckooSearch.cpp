@@ -3,17 +3,14 @@
 
 CuckooSearch::CuckooSearch(ObjectiveFunction func, unsigned amount_of_nests, Step step, Lambda lambda, double prob,
 	unsigned max_generations, StopCritearian stop_crierian, bool use_lazy_cuckoo) :
-	m_objective_function(func), m_amount_of_nests(amount_of_nests), m_step(step), m_lambda(lambda), m_abandon_probability(prob),
-	m_max_generations(max_generations), m_stop_criterian(stop_crierian), m_use_lazy_cuckoo(use_lazy_cuckoo)
+	m_amount_of_nests(amount_of_nests), m_objective_function(func), m_stop_criterian(stop_crierian), m_max_generations(max_generations),
+	m_lambda(lambda), m_step(step), m_abandon_probability(prob), m_use_lazy_cuckoo(use_lazy_cuckoo),
+	m_executor(Executor::Create()), m_seed(0), m_use_fixed_seed(false), m_flight_block_size(16),
+	m_subspace_block_size(0), m_subspace_blocks(1),
+	m_stop_reason(StopReason::NONE), m_evaluations(0), m_minimize(true), m_checkpoint_interval(0),
+	m_stagnation(0), m_stagnation_best(0.0)
 {
-	if (m_use_lazy_cuckoo)
-	{
-		m_cuckoo = new LazyCuckoo(m_objective_function);
-	}
-	else
-	{
-		m_cuckoo = new Cuckoo(m_objective_function);
-	}
+	CreateCuckoo();
 	if (m_step.GetMinStep().size() == 1 || m_step.GetMaxStep().size() == 1)
 	{
 		m_step.SetMinStep(std::valarray<double>(m_step.GetMinStep()[0], func.GetNumberOfDimensions()));
@@ -23,20 +20,18 @@ CuckooSearch::CuckooSearch(ObjectiveFunction func, unsigned amount_of_nests, Ste
 
 CuckooSearch::~CuckooSearch()
 {
-	//ERROR: Can't delete pointer
-	//delete m_cuckoo;
 };
 
 std::valarray<double> CuckooSearch::FindMax()
 {
-	m_cmp_fitness = [](const Nest& ls, const Nest& rs) {return (ls > rs); };
+	SetDirection(false);
 
 	return GetSolution();
 };
 
 std::valarray<double> CuckooSearch::FindMin()
 {
-	m_cmp_fitness = [](const Nest& ls, const Nest& rs) {return (ls < rs); };
+	SetDirection(true);
 
 	return GetSolution();
 };
@@ -61,111 +56,697 @@ std::valarray<double> CuckooSearch::FindMin(Lambda lambda, Step step, double pro
 
 void CuckooSearch::UseLazyCuckoo()
 {
-	delete m_cuckoo;
-	m_cuckoo = new LazyCuckoo(m_objective_function);
 	m_use_lazy_cuckoo = true;
+	CreateCuckoo();
 };
 
 void CuckooSearch::UseStandartCuckoo()
 {
-	delete m_cuckoo;
-	m_cuckoo = new Cuckoo(m_objective_function);
 	m_use_lazy_cuckoo = false;
+	CreateCuckoo();
+};
+
+void CuckooSearch::SetSubspaceFlights(unsigned int block_size, unsigned int blocks)
+{
+	m_subspace_block_size = block_size;
+	m_subspace_blocks = std::max(1u, blocks);
+	CreateCuckoo();
+};
+
+void CuckooSearch::CreateCuckoo()
+{
+	//Copies of search share cuckoo, so settings are changed in new cuckoo
+	if (m_use_lazy_cuckoo)
+	{
+		m_cuckoo = std::make_shared<LazyCuckoo>(m_objective_function);
+	}
+	else
+	{
+		m_cuckoo = std::make_shared<Cuckoo>(m_objective_function);
+	}
+	m_cuckoo->SetSubspace(m_subspace_block_size, m_subspace_blocks);
+	m_cuckoo->SetConstraints(m_constraints);
+};
+
+void CuckooSearch::SetObjectiveFunction(ObjectiveFunction func)
+{
+	m_objective_function = func;
+	CreateCuckoo();
+};
+
+void CuckooSearch::SetConstraints(std::shared_ptr<const ConstraintSet> constraints)
+{
+	m_constraints = constraints;
+	CreateCuckoo();
+};
+
+void CuckooSearch::StartMin()
+{
+	SetDirection(true);
+	StartSearch();
+};
+
+void CuckooSearch::StartMax()
+{
+	SetDirection(false);
+	StartSearch();
+};
+
+void CuckooSearch::SetDirection(bool minimize)
+{
+	m_minimize = minimize;
+	if (minimize)
+	{
+		m_cmp_fitness = [](double ls, double rs) {return (ls < rs); };
+	}
+	else
+	{
+		m_cmp_fitness = [](double ls, double rs) {return (ls > rs); };
+	}
+	m_evaluated_function = m_objective_function;
+	if (m_constraints)
+	{
+		m_cmp_fitness = m_constraints->GetCompareFitness(minimize);
+		m_evaluated_function = m_constraints->Wrap(m_objective_function, minimize);
+	}
 };
 
 std::valarray<double> CuckooSearch::GetSolution()
 {
-	srand(static_cast<unsigned int>(time(nullptr)));
+	StartSearch();
+	while (NextGeneration())
+	{
+	}
+	WaitForCheckpoint();
+
+	return m_best_ever.GetSolutions();
+};
+
+void CuckooSearch::StartSearch()
+{
+	if (!m_use_fixed_seed)
+	{
+		m_seed = RandomEngine::GetRandomSeed();
+	}
 	m_current_generation = 1;
+	m_profile.Reset();
+	m_stop_reason = StopReason::NONE;
+	m_evaluations = 0;
+	m_start_time = std::chrono::steady_clock::now();
 
-	Concurrency::critical_section critical_section;
-	m_delta_step = std::pow((m_step.GetMinStep() / m_step.GetMaxStep()), 1.0 / double(m_max_generations));
+	m_step_ratio = m_step.GetMinStep() / m_step.GetMaxStep();
 	GenerateInitialPopulation();
-	m_best_ever = m_nests[0];
+	m_best_ever = m_population.GetNest(m_ranking.GetBest());
+	m_stagnation = 0;
+	m_stagnation_best = m_best_ever.GetFitness();
+};
+
+bool CuckooSearch::NextGeneration()
+{
+	if (IsStopped())
+		return false;
 
-	while ((m_current_generation <= m_max_generations) && m_stop_criterian())
+	//Islands and other drivers don't always collect statistics
+	if (m_statistics_handler)
 	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::STATISTICS_HANDLER);
 		m_statistics_handler();
+	}
 
-		RecalculateLambdas();
-		RecalculateStep();
+	RecalculateLambdas();
+	RecalculateStep();
 
-		Concurrency::parallel_for<unsigned int>(0, m_amount_of_nests, [&](unsigned int i)
+	//Cuckoos fly by blocks: flights of block are evaluated together,
+	//next block starts from nests, which were replaced by previous blocks
+	for (unsigned int block = 0; block < m_amount_of_nests; block += m_flight_block_size)
+	{
+		if (IsBudgetExhausted())
+			break;
+		//Block is cut, so its evaluations don't exceed budget of evaluations
+		const unsigned int block_end = block + GetBudgetedRows(std::min(m_amount_of_nests, block + m_flight_block_size) - block,
+			m_cuckoo->GetNumberOfCandidates());
+		if (block_end == block)
 		{
-			Nest new_solution = m_cuckoo->MakeFlight(m_nests[i]);
-			unsigned int random_index = rand() % m_amount_of_nests;
-			if (m_cmp_fitness(new_solution, m_nests[random_index]))
-			{
-				critical_section.lock();
-				m_nests[random_index] = new_solution;
-				if (m_cmp_fitness(m_nests[0], m_best_ever))
-				{
-					m_best_ever = m_nests[0];
-				}
-				critical_section.unlock();
-			}
-		});
+			//The rest of budget is less than evaluations of flight
+			m_stop_reason = StopReason::MAX_EVALUATIONS;
+			break;
+		}
+		MakeFlights(block, block_end);
+		ReplaceNests(block, block_end);
+	}
 
-		RankNests();
+	//Replacements only improve nests, so after ranking the best nest is first
+	RankNests();
+	UpdateBestEver(m_ranking.GetBest(), m_ranking.GetBest() + 1);
+	if (!IsBudgetExhausted())
+	{
 		AbandonNests();
-		++m_current_generation;
 	}
+	UpdateStagnation();
+	++m_current_generation;
+	ScheduleCheckpoint();
+	return true;
+};
+
+SetOfNests CuckooSearch::GetBestNests(unsigned int count) const
+{
+	//Abandoned nests aren't ranked until next generation, so nests are sorted here
+	count = std::min(count, m_population.GetSize());
+	std::vector<unsigned int> order(m_ranking.GetOrder());
+	std::partial_sort(order.begin(), order.begin() + count, order.end(), [&](unsigned int ls, unsigned int rs)
+	{
+		return m_cmp_fitness(m_population.GetFitness(ls), m_population.GetFitness(rs));
+	});
+
+	SetOfNests nests(count);
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		nests[i] = m_population.GetNest(order[i]);
+	}
+	return nests;
+};
+
+void CuckooSearch::ImportNests(const SetOfNests& nests)
+{
+	//Migrants take places of the worst nests, if they are better
+	RankNests();
+	for (unsigned int i = 0; i < nests.size() && i < m_amount_of_nests; ++i)
+	{
+		const unsigned int index = m_ranking[m_amount_of_nests - 1 - i];
+		if (nests[i].GetSolutionsRef().size() != m_population.GetDimensions())
+			throw std::runtime_error("Dimensions of imported nest and population aren't equal\n");
+		if (m_cmp_fitness(nests[i].GetFitness(), m_population.GetFitness(index)))
+		{
+			m_population.Assign(index, &nests[i].GetSolutionsRef()[0], nests[i].GetFitness());
+			m_ranking.MarkChanged(index);
+		}
+	}
+	RankNests();
+	UpdateBestEver(m_ranking.GetBest(), m_ranking.GetBest() + 1);
+};
+
+SearchCheckpoint CuckooSearch::CreateCheckpoint() const
+{
+	const unsigned int dimensions = m_population.GetDimensions();
+	SearchCheckpoint checkpoint;
+	checkpoint.nests = m_amount_of_nests;
+	checkpoint.dimensions = dimensions;
+	checkpoint.generation = m_current_generation;
+	checkpoint.max_generations = m_max_generations;
+	checkpoint.flight_block_size = m_flight_block_size;
+	checkpoint.minimize = m_minimize;
+	checkpoint.lazy_cuckoo = m_use_lazy_cuckoo;
+	checkpoint.seed = m_seed;
+	checkpoint.evaluations = m_evaluations;
+	checkpoint.elapsed_seconds = GetElapsedSeconds();
+	checkpoint.stagnation = m_stagnation;
+	checkpoint.stagnation_best = m_stagnation_best;
+
+	//Rows of population are padded, checkpoint keeps compact matrix
+	checkpoint.solutions.resize(static_cast<std::size_t>(m_amount_of_nests) * dimensions);
+	checkpoint.fitness.resize(m_amount_of_nests);
+	checkpoint.lambda.resize(m_amount_of_nests);
+	for (unsigned int i = 0; i < m_amount_of_nests; ++i)
+	{
+		const double* solution = m_population.GetSolution(i);
+		std::copy(solution, solution + dimensions, checkpoint.solutions.begin() + static_cast<std::size_t>(i) * dimensions);
+		checkpoint.fitness[i] = m_population.GetFitness(i);
+		checkpoint.lambda[i] = m_population.GetLambda(i);
+	}
+	const Egg& best = m_best_ever.GetSolutionsRef();
+	checkpoint.order = m_ranking.GetOrder();
+	checkpoint.best_solution.assign(std::begin(best), std::end(best));
+	checkpoint.best_fitness = m_best_ever.GetFitness();
+	checkpoint.best_lambda = m_best_ever.GetLambda();
+	return checkpoint;
+};
+
+void CuckooSearch::RestoreCheckpoint(const SearchCheckpoint& checkpoint)
+{
+	const unsigned int dimensions = m_objective_function.GetNumberOfDimensions();
+	if (checkpoint.nests != m_amount_of_nests || checkpoint.dimensions != dimensions)
+		throw std::runtime_error("Checkpoint doesn't match number of nests or dimensions of search\n");
+	if (checkpoint.best_solution.size() != dimensions)
+		throw std::runtime_error("Checkpoint has wrong size of best solution\n");
+
+	SetDirection(checkpoint.minimize);
+	if (checkpoint.lazy_cuckoo != m_use_lazy_cuckoo)
+	{
+		if (checkpoint.lazy_cuckoo)
+			UseLazyCuckoo();
+		else
+			UseStandartCuckoo();
+	}
+	m_seed = checkpoint.seed;
+	m_max_generations = checkpoint.max_generations;
+	m_flight_block_size = std::max(1u, static_cast<unsigned int>(checkpoint.flight_block_size));
+
+	AllocateBuffers();
+	for (unsigned int i = 0; i < m_amount_of_nests; ++i)
+	{
+		m_population.Assign(i, &checkpoint.solutions[static_cast<std::size_t>(i) * dimensions], checkpoint.fitness[i]);
+		m_population.SetLambda(i, checkpoint.lambda[i]);
+	}
+	//Abandoned nests of checkpoint aren't ranked yet, so order is restored as is
+	m_ranking.Assign(checkpoint.order);
+	m_best_ever = Nest(Egg(checkpoint.best_solution.data(), dimensions), checkpoint.best_fitness, checkpoint.best_lambda);
+
+	m_current_generation = checkpoint.generation;
+	m_evaluations = checkpoint.evaluations;
+	m_stagnation = checkpoint.stagnation;
+	m_stagnation_best = checkpoint.stagnation_best;
+	m_stop_reason = StopReason::NONE;
+	m_profile.Reset();
+	m_step_ratio = m_step.GetMinStep() / m_step.GetMaxStep();
+	//Time limit counts time of search before break too
+	m_start_time = std::chrono::steady_clock::now() -
+		std::chrono::duration_cast<std::chrono::steady_clock::duration>(std::chrono::duration<double>(checkpoint.elapsed_seconds));
+};
+
+void CuckooSearch::SaveCheckpoint(const std::string& file_path) const
+{
+	WriteCheckpoint(file_path, CreateCheckpoint());
+};
+
+void CuckooSearch::LoadCheckpoint(const std::string& file_path)
+{
+	RestoreCheckpoint(ReadCheckpoint(file_path));
+};
+
+std::valarray<double> CuckooSearch::Resume(const std::string& file_path)
+{
+	LoadCheckpoint(file_path);
+	while (NextGeneration())
+	{
+	}
+	WaitForCheckpoint();
 
 	return m_best_ever.GetSolutions();
 };
 
+void CuckooSearch::SetCheckpointing(const std::string& file_path, unsigned int interval)
+{
+	WaitForCheckpoint();
+	m_checkpoint_interval = interval;
+	if (interval == 0)
+	{
+		m_checkpoint_writer.reset();
+		return;
+	}
+	if (!m_checkpoint_writer || m_checkpoint_writer->GetFilePath() != file_path)
+	{
+		m_checkpoint_writer = std::make_shared<CheckpointWriter>(file_path);
+	}
+};
+
+void CuckooSearch::ScheduleCheckpoint()
+{
+	//Search only copies state, checkpoint is written on background thread
+	if (m_checkpoint_writer && (m_current_generation - 1) % m_checkpoint_interval == 0)
+	{
+		m_checkpoint_writer->Write(std::unique_ptr<SearchCheckpoint>(new SearchCheckpoint(CreateCheckpoint())));
+	}
+};
+
+void CuckooSearch::WaitForCheckpoint()
+{
+	if (m_checkpoint_writer)
+	{
+		m_checkpoint_writer->Wait();
+	}
+};
+
+SetOfNests CuckooSearch::GetCurrentSetOfNests() const
+{
+	SetOfNests nests(m_population.GetSize());
+	for (unsigned int i = 0; i < m_population.GetSize(); ++i)
+	{
+		nests[i] = m_population.GetNest(m_ranking[i]);
+	}
+	return nests;
+};
+
 void CuckooSearch::GenerateInitialPopulation()
 {
-	m_nests = std::vector<Nest>(m_amount_of_nests);
-	Concurrency::parallel_for<unsigned int>(0, m_amount_of_nests, [&](unsigned int i)
+	AllocateBuffers();
+	m_executor->ParallelFor(0, m_amount_of_nests, [&](unsigned int i)
 	{
-		m_nests[i] = Nest(m_objective_function);
+		RandomEngine random_engine = GetRandomEngine(INITIALIZATION, i);
+		Population::GenerateSolution(m_population.GetSolution(i), m_bounds, random_engine);
+		if (m_constraints)
+		{
+			m_constraints->Repair(m_population.GetSolution(i), m_bounds);
+		}
 	});
+	EvaluateRows(m_population, 0, m_amount_of_nests);
 	RankNests();
 	RecalculateLambdas();
 	RecalculateStep();
 };
 
+void CuckooSearch::AllocateBuffers()
+{
+	m_bounds = m_objective_function.GetBounds();
+	m_population.Resize(m_amount_of_nests, m_objective_function.GetNumberOfDimensions());
+	m_new_solutions.Resize(m_amount_of_nests, m_objective_function.GetNumberOfDimensions());
+	m_candidates.Resize(m_amount_of_nests * m_cuckoo->GetNumberOfCandidates(), m_objective_function.GetNumberOfDimensions());
+	m_ranking.Reset(m_amount_of_nests);
+	m_targets.resize(m_amount_of_nests);
+	m_proposals.assign(m_amount_of_nests, -1);
+	m_changed_coordinates.resize(static_cast<std::size_t>(m_amount_of_nests) * std::max(1u, m_cuckoo->GetSubspaceSize()));
+	m_changed_counts.resize(m_amount_of_nests);
+	m_best_rows.reserve(m_amount_of_nests);
+};
+
 void CuckooSearch::AbandonNests()
 {
 	if (m_abandon_probability < 0 || m_abandon_probability > 1)
 	{
-		throw std::exception("Abandon probability must be in range [0, 1]\n");
+		throw std::runtime_error("Abandon probability must be in range [0, 1]\n");
+	}
+	RandomEngine index_engine = GetRandomEngine(ABANDON, m_amount_of_nests);
+	unsigned int rnd_index = static_cast<unsigned int>(m_amount_of_nests - m_abandon_probability * index_engine.Uniform() * m_amount_of_nests);
+	//The worst nests are abandoned, while new nests fit into budget of evaluations
+	rnd_index = m_amount_of_nests - GetBudgetedRows(m_amount_of_nests - rnd_index, 1);
+
+	//Nests with ranks [rnd_index, amount_of_nests) are abandoned, new nests are
+	//generated in the same rows of buffer, so they are evaluated by one batch.
+	//New nests keep ranks of abandoned nests until next ranking
+	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::ABANDON);
+		m_executor->ParallelFor(rnd_index, m_amount_of_nests, [&](unsigned int i)
+		{
+			RandomEngine random_engine = GetRandomEngine(ABANDON, i);
+			Population::GenerateSolution(m_new_solutions.GetSolution(i), m_bounds, random_engine);
+			if (m_constraints)
+			{
+				m_constraints->Repair(m_new_solutions.GetSolution(i), m_bounds);
+			}
+		});
+	}
+	CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::ABANDONMENTS, m_amount_of_nests - rnd_index);
+	EvaluateRows(m_new_solutions, rnd_index, m_amount_of_nests);
+	unsigned int best = m_amount_of_nests;
+	for (unsigned int i = rnd_index; i < m_amount_of_nests; ++i)
+	{
+		const unsigned int index = m_ranking[i];
+		m_population.Assign(index, m_new_solutions.GetSolution(i), m_new_solutions.GetFitness(i));
+		m_ranking.MarkChanged(index);
+		if (best == m_amount_of_nests || m_cmp_fitness(m_population.GetFitness(index), m_population.GetFitness(best)))
+		{
+			best = index;
+		}
+	}
+	if (best != m_amount_of_nests)
+	{
+		UpdateBestEver(best, best + 1);
+	}
+};
+
+void CuckooSearch::MakeFlights(unsigned int begin, unsigned int end)
+{
+	//i-cuckoo flies from nest with rank i, its candidates are rows [i * k, (i + 1) * k) of m_candidates
+	const unsigned int candidates_per_flight = m_cuckoo->GetNumberOfCandidates();
+	const unsigned int subspace_size = m_cuckoo->GetSubspaceSize();
+	{
+		CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::FLIGHT_GENERATION);
+		m_executor->ParallelFor(begin, end, [&](unsigned int i)
+		{
+			RandomEngine random_engine = GetRandomEngine(FLIGHT, i);
+			const unsigned int host = m_ranking[i];
+			m_changed_counts[i] = m_cuckoo->GenerateCandidates(m_population.GetSolution(host), m_population.GetLambda(host), &m_alpha[0], m_bounds,
+				random_engine, m_candidates.GetSolution(i * candidates_per_flight), m_candidates.GetStride(), &m_changed_coordinates[i * subspace_size]);
+			m_targets[i] = m_ranking[random_engine.UniformIndex(m_amount_of_nests)];
+		});
+	}
+
+	if (subspace_size > 0 && m_evaluated_function.HasIncrementalFunction())
+	{
+		EvaluateChanges(begin, end);
+	}
+	else
+	{
+		EvaluateRows(m_candidates, begin * candidates_per_flight, end * candidates_per_flight);
+	}
+
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::CANDIDATE_SELECTION);
+	m_executor->ParallelFor(begin, end, [&](unsigned int i)
+	{
+		const unsigned int first = i * candidates_per_flight;
+		const unsigned int host = m_ranking[i];
+		const int chosen = m_cuckoo->SelectCandidate(m_population.GetFitness(host), m_candidates.GetFitnessData() + first, m_cmp_fitness);
+		if (chosen == Cuckoo::HOST_CANDIDATE)
+		{
+			m_new_solutions.Assign(i, m_population.GetSolution(host), m_population.GetFitness(host));
+		}
+		else
+		{
+			m_new_solutions.Assign(i, m_candidates.GetSolution(first + chosen), m_candidates.GetFitness(first + chosen));
+		}
+	});
+};
+
+void CuckooSearch::ReplaceNests(unsigned int begin, unsigned int end)
+{
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::REPLACEMENT);
+	//Proposals for the same nest: the best wins, the first cuckoo wins ties (as in sequential updates)
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		const int proposal = m_proposals[m_targets[i]];
+		if (proposal < 0 || m_cmp_fitness(m_new_solutions.GetFitness(i), m_new_solutions.GetFitness(proposal)))
+		{
+			m_proposals[m_targets[i]] = static_cast<int>(i);
+		}
+	}
+	//Winner replaces nest only if it's better
+	unsigned int replacements = 0;
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		const unsigned int target = m_targets[i];
+		if (m_proposals[target] != static_cast<int>(i))
+			continue;
+		if (m_cmp_fitness(m_new_solutions.GetFitness(i), m_population.GetFitness(target)))
+		{
+			m_ranking.MarkChanged(target);
+			++replacements;
+		}
+		else
+		{
+			m_proposals[target] = -1;
+		}
+	}
+	CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::REPLACEMENTS, replacements);
+	if (replacements == 0)
+		return;
+
+	//Each nest is written only by its winner
+	m_executor->ParallelFor(begin, end, [&](unsigned int i)
+	{
+		const unsigned int target = m_targets[i];
+		if (m_proposals[target] != static_cast<int>(i))
+			return;
+		m_proposals[target] = -1;
+		m_population.Assign(target, m_new_solutions.GetSolution(i), m_new_solutions.GetFitness(i));
+	});
+};
+
+void CuckooSearch::UpdateBestEver(unsigned int begin, unsigned int end)
+{
+	if (begin >= end)
+		return;
+
+	//Each block finds own best row, blocks are reduced in fixed order
+	const unsigned int rows = end - begin;
+	const unsigned int block_size = std::max(1u, rows / (4 * m_executor->GetNumberOfThreads()));
+	const unsigned int blocks = (rows + block_size - 1) / block_size;
+	m_best_rows.resize(blocks);
+	m_executor->ParallelFor(0, blocks, [&](unsigned int block)
+	{
+		const unsigned int first = begin + block * block_size;
+		const unsigned int last = std::min(end, first + block_size);
+		unsigned int best = first;
+		for (unsigned int i = first + 1; i < last; ++i)
+		{
+			if (m_cmp_fitness(m_population.GetFitness(i), m_population.GetFitness(best)))
+			{
+				best = i;
+			}
+		}
+		m_best_rows[block] = best;
+	});
+
+	unsigned int best = m_best_rows[0];
+	for (unsigned int row : m_best_rows)
+	{
+		if (m_cmp_fitness(m_population.GetFitness(row), m_population.GetFitness(best)))
+		{
+			best = row;
+		}
+	}
+	if (m_cmp_fitness(m_population.GetFitness(best), m_best_ever.GetFitness()))
+	{
+		m_population.CopyNest(best, m_best_ever);
 	}
-	unsigned int rnd_index = static_cast<unsigned int>(m_amount_of_nests - m_abandon_probability * (rand() / double(RAND_MAX + 1.0)) * m_amount_of_nests);
+};
+
+void CuckooSearch::EvaluateRows(Population& population, unsigned int begin, unsigned int end)
+{
+	if (begin >= end)
+		return;
+
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::EVALUATION);
+	CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::EVALUATIONS, end - begin);
+	m_evaluations += end - begin;
+	//Few blocks per thread, each block is one call of batch function
+	const unsigned int rows = end - begin;
+	const unsigned int block_size = std::max(1u, rows / (4 * m_executor->GetNumberOfThreads()));
+	const unsigned int blocks = (rows + block_size - 1) / block_size;
+	m_executor->ParallelFor(0, blocks, [&](unsigned int block)
+	{
+		const unsigned int first = begin + block * block_size;
+		const unsigned int count = std::min(block_size, end - first);
+		m_evaluated_function.Evaluate(population.GetSolution(first), count, population.GetStride(),
+			population.GetFitnessData() + first);
+	});
+};
 
-	Concurrency::parallel_for<unsigned int>(rnd_index, m_amount_of_nests, [&](unsigned int i)
+void CuckooSearch::EvaluateChanges(unsigned int begin, unsigned int end)
+{
+	const unsigned int candidates_per_flight = m_cuckoo->GetNumberOfCandidates();
+	const unsigned int subspace_size = m_cuckoo->GetSubspaceSize();
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::EVALUATION);
+	CUCKOO_PROFILE_COUNT(m_profile, ProfileCounter::EVALUATIONS, (end - begin) * candidates_per_flight);
+	m_evaluations += (end - begin) * candidates_per_flight;
+	//Candidates differ from host only in changed coordinates
+	m_executor->ParallelFor(begin, end, [&](unsigned int i)
 	{
-		m_nests[i] = Nest(m_objective_function);
+		const unsigned int host = m_ranking[i];
+		for (unsigned int candidate = i * candidates_per_flight; candidate < (i + 1) * candidates_per_flight; ++candidate)
+		{
+			m_candidates.SetFitness(candidate, m_evaluated_function.EvaluateChange(m_candidates.GetSolution(candidate),
+				m_population.GetSolution(host), m_population.GetFitness(host), &m_changed_coordinates[i * subspace_size], m_changed_counts[i]));
+		}
 	});
 };
 
 void CuckooSearch::RankNests()
 {
-	Concurrency::parallel_sort<std::vector<Nest>::iterator>(m_nests.begin(), m_nests.end(), m_cmp_fitness);
+	CUCKOO_PROFILE_SCOPE(m_profile, ProfilePhase::RANKING);
+	m_ranking.Update(m_population.GetFitnessData(), m_cmp_fitness);
 };
 
 void CuckooSearch::RecalculateStep()
 {
-	Concurrency::parallel_for<unsigned int>(0, m_amount_of_nests, [&](unsigned int i)
+	//Step is the same for all nests
+	//Step is computed in place, generation doesn't allocate memory
+	const std::valarray<double>& max_step = m_step.GetMaxStepRef();
+	const double progress = GetProgress();
+	if (m_alpha.size() != max_step.size())
 	{
-		std::valarray<double> new_alpha = m_step.GetMaxStep() * std::pow(m_delta_step, double(m_current_generation));
-		m_nests[i].SetAlpha(new_alpha);
-	});
+		m_alpha.resize(max_step.size());
+	}
+	for (size_t i = 0; i < m_alpha.size(); ++i)
+	{
+		m_alpha[i] = max_step[i] * std::pow(m_step_ratio[i], progress);
+	}
+};
+
+double CuckooSearch::GetElapsedSeconds() const
+{
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start_time).count();
+};
+
+double CuckooSearch::GetProgress() const
+{
+	double progress = double(m_current_generation) / double(std::max(1u, m_max_generations));
+	if (m_budget.GetMaxEvaluations() > 0)
+	{
+		progress = std::max(progress, double(m_evaluations) / double(m_budget.GetMaxEvaluations()));
+	}
+	if (m_budget.GetDeadline() > 0.0)
+	{
+		progress = std::max(progress, GetElapsedSeconds() / m_budget.GetDeadline());
+	}
+	return std::min(progress, 1.0);
+};
+
+bool CuckooSearch::IsStopped()
+{
+	if (m_current_generation > m_max_generations)
+	{
+		m_stop_reason = StopReason::MAX_GENERATIONS;
+	}
+	else if (m_budget.UseTargetFitness() && !m_cmp_fitness(m_budget.GetTargetFitness(), m_best_ever.GetFitness()))
+	{
+		m_stop_reason = StopReason::TARGET_FITNESS;
+	}
+	else if (m_budget.GetStagnationGenerations() > 0 && m_stagnation >= m_budget.GetStagnationGenerations())
+	{
+		m_stop_reason = StopReason::STAGNATION;
+	}
+	else if (!IsBudgetExhausted() && !m_stop_criterian())
+	{
+		m_stop_reason = StopReason::STOP_CRITERIAN;
+	}
+	return m_stop_reason != StopReason::NONE;
+};
+
+bool CuckooSearch::IsBudgetExhausted()
+{
+	if (m_budget.GetMaxEvaluations() > 0 && m_evaluations >= m_budget.GetMaxEvaluations())
+	{
+		m_stop_reason = StopReason::MAX_EVALUATIONS;
+	}
+	else if (m_budget.GetDeadline() > 0.0 && GetElapsedSeconds() >= m_budget.GetDeadline())
+	{
+		m_stop_reason = StopReason::DEADLINE;
+	}
+	return m_stop_reason != StopReason::NONE;
+};
+
+unsigned int CuckooSearch::GetBudgetedRows(unsigned int rows, unsigned int evaluations_per_row) const
+{
+	if (m_budget.GetMaxEvaluations() == 0)
+		return rows;
+	const unsigned long long rest = (m_evaluations < m_budget.GetMaxEvaluations()) ? m_budget.GetMaxEvaluations() - m_evaluations : 0;
+	return static_cast<unsigned int>(std::min<unsigned long long>(rows, rest / std::max(1u, evaluations_per_row)));
+};
+
+void CuckooSearch::UpdateStagnation()
+{
+	//Improvement resets counter only if it's bigger than epsilon
+	const double best = m_best_ever.GetFitness();
+	if (m_cmp_fitness(best, m_stagnation_best) && std::fabs(best - m_stagnation_best) > m_budget.GetStagnationEpsilon())
+	{
+		m_stagnation_best = best;
+		m_stagnation = 0;
+	}
+	else
+	{
+		++m_stagnation;
+	}
 };
 
 void CuckooSearch::RecalculateLambdas()
 {
 	if (m_amount_of_nests == 1)
 	{
-		m_nests[0].SetLambda(m_lambda.GetMinLambda() + (m_lambda.GetMaxLamda() - m_lambda.GetMinLambda()) / 2.0);
+		m_population.SetLambda(0, m_lambda.GetMinLambda() + (m_lambda.GetMaxLamda() - m_lambda.GetMinLambda()) / 2.0);
 		return;
 	}
 	const double delta_lambda = m_lambda.GetMaxLamda() - m_lambda.GetMinLambda();
 
-	Concurrency::parallel_for<unsigned int>(0, m_amount_of_nests, [&](unsigned int i)
+	//Lambda depends on rank of nest
+	for (unsigned int i = 0; i < m_amount_of_nests; ++i)
 	{ 
 		double new_lambda = m_lambda.GetMaxLamda() - (double(i) * (delta_lambda)) / double(m_amount_of_nests - 1);
-		m_nests[i].SetLambda(new_lambda);
-	});
+		m_population.SetLambda(m_ranking[i], new_lambda);
+	}
 };
+
+RandomEngine CuckooSearch::GetRandomEngine(RandomPhase phase, unsigned int index) const
+{
+	//Stream depends only on (generation, phase, index), not on thread which executes task
+	const std::uint64_t stream = (std::uint64_t(m_current_generation) << 34) | (std::uint64_t(phase) << 32) | index;
+	return RandomEngine(m_seed, stream);
+};
\ No newline at end of file
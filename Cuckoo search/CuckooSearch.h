@@ -9,12 +9,29 @@
 		number of generation and change by this law:
 		a(t) = a(0) * delta^t;
 		delta = (a(min) / a(max))^(1 / k), where k - maximum number of iterations, t - current iteration.
+		With budget (SearchBudget) t / k is progress of search - the biggest consumed
+		part of generations, evaluations and time, so step reaches a(min) when any budget ends.
+		Budget of evaluations isn't exceeded: the last block of flights and abandoned nests are cut by the rest of budget.
 
 		b) variable lambda which depends on current cuckoo position - cuckoos with better
 		fitness have max lambda and can explore solution more precisly.
 		Lambda calculates for formula:
 		lambda(i) = lambda(max) - (i * (lambda(max) - lambda(min))) / (m - 1), where
 		lambda(i) - is lambda for i-cuckoo, i - cuckoo position, m - amount of nests.  
+
+		Nests are stored in Population (structure of arrays), step (alpha) and bounds
+		are common for all nests and are stored once.
+		Cuckoos fly by blocks (flight block size): candidates of block are evaluated
+		together by ObjectiveFunction::Evaluate, after that they replace random nests.
+		Next block flies from already updated nests. Block with 1 cuckoo gives
+		sequential algorithm, big blocks give more parallel evaluations, but
+		less updates during generation.
+		Update of block has no locks: each cuckoo proposes its egg for random nest,
+		proposals for the same nest are reduced to the best one in order of cuckoos,
+		after that winners replace their nests in parallel (each nest has one winner).
+		So result doesn't depend on number of threads.
+		Constraints (SetConstraints, Constraints.h) are checked before objective,
+		flights and new nests are repaired, fitness is compared by m_cmp_fitness of constraints.
 */
 
 
@@ -25,6 +42,14 @@
 #include "LevyFlight.h"
 #include "Cuckoo.h"
 #include "Nest.h"
+#include "Population.h"
+#include "Executor.h"
+#include "Random.h"
+#include "Profiling.h"
+#include "SearchBudget.h"
+#include "Checkpoint.h"
+#include "Ranking.h"
+#include "Constraints.h"
 
 #include <functional>
 #include <vector>
@@ -34,8 +59,8 @@
 #include <string>
 #include <fstream>
 #include <iostream>
-
-#include <ppl.h>
+#include <memory>
+#include <chrono>
 
 using SetOfNests = std::vector<Nest>;
 
@@ -79,6 +104,7 @@ public:
 
 	inline std::valarray<double> GetMinStep() const { return m_min_step; };
 	inline std::valarray<double> GetMaxStep() const { return m_max_step; };
+	inline const std::valarray<double>& GetMaxStepRef() const { return m_max_step; };
 
 private:
 	std::valarray<double> m_min_step;
@@ -90,13 +116,36 @@ class CuckooSearch
 public:
 	CuckooSearch(ObjectiveFunction func, unsigned amount_of_nests = 32, Step step = 1.0, Lambda lambda = {0.3, 1.99}, double prob = 0.25,
 		unsigned max_generations = 10000, StopCritearian stop_crierian = []() {return true; }, bool use_lazy_cuckoo = false);
-	~CuckooSearch();
+	virtual ~CuckooSearch();
 
 	std::valarray<double> FindMax();
 	std::valarray<double> FindMin();
 	std::valarray<double> FindMax(Lambda lambda, Step step, double prob, StopCritearian stop_criterian = []() {return true; });
 	std::valarray<double> FindMin(Lambda lambda, Step step, double prob, StopCritearian stop_criterian = []() {return true; });
 
+	//Step by step search: StartMin (StartMax), then NextGeneration while it returns true
+	void StartMin();
+	void StartMax();
+	virtual bool NextGeneration();
+	//The best nests of current population, the best is first
+	SetOfNests GetBestNests(unsigned int count) const;
+	//Nests (migrants) replace the worst nests of population, if they are better
+	void ImportNests(const SetOfNests& nests);
+
+	//Checkpoints: search resumed from checkpoint continues as search without break
+	SearchCheckpoint CreateCheckpoint() const;
+	virtual void RestoreCheckpoint(const SearchCheckpoint& checkpoint);
+	void SaveCheckpoint(const std::string& file_path) const;
+	void LoadCheckpoint(const std::string& file_path);
+	//Loads checkpoint and continues search to the end
+	std::valarray<double> Resume(const std::string& file_path);
+	//Checkpoint is written on background thread after each interval generations (interval = 0 - no checkpoints)
+	void SetCheckpointing(const std::string& file_path, unsigned int interval);
+	//Waits until background checkpoint is written
+	void WaitForCheckpoint();
+	inline unsigned int GetCheckpointInterval() const { return m_checkpoint_interval; };
+	inline std::string GetCheckpointPath() const { return m_checkpoint_writer ? m_checkpoint_writer->GetFilePath() : std::string(); };
+
 	inline double GetCurrentBestValue() const { return m_best_ever.GetFitness(); };
 	inline Nest GetCurrentBestNest() const { return m_best_ever; };
 	inline unsigned GetMaxGenerations() const { return m_max_generations; };
@@ -106,9 +155,28 @@ public:
 	inline double GetAbandonProbability() const { return m_abandon_probability; };
 	inline ObjectiveFunction GetObjectiveFunction() const { return m_objective_function; };
 	inline StopCritearian GetStopCriterian() const { return m_stop_criterian; };
-	inline SetOfNests GetCurrentSetOfNests() const { return m_nests; };
+	inline CompareFitness GetCompareFitness() const { return m_cmp_fitness; };
+	SetOfNests GetCurrentSetOfNests() const;
+	inline const Population& GetPopulation() const { return m_population; };
+	inline std::valarray<double> GetAlpha() const { return m_alpha; };
 	inline unsigned GetNumberOfNests() const { return m_amount_of_nests; };
 	inline bool IsLazyCuckoo() const { return m_use_lazy_cuckoo; };
+	inline std::shared_ptr<Executor> GetExecutor() const { return m_executor; };
+	inline std::uint64_t GetSeed() const { return m_seed; };
+	inline bool IsFixedSeed() const { return m_use_fixed_seed; };
+	inline unsigned int GetFlightBlockSize() const { return m_flight_block_size; };
+	inline unsigned int GetSubspaceBlockSize() const { return m_subspace_block_size; };
+	inline unsigned int GetSubspaceBlocks() const { return m_subspace_blocks; };
+	inline const SearchBudget& GetBudget() const { return m_budget; };
+	inline std::shared_ptr<const ConstraintSet> GetConstraints() const { return m_constraints; };
+	inline StopReason GetStopReason() const { return m_stop_reason; };
+	//Objective evaluations of current run
+	inline unsigned long long GetEvaluations() const { return m_evaluations; };
+	double GetElapsedSeconds() const;
+	//Consumed part of budget in range [0, 1]
+	double GetProgress() const;
+	//Profile of the last run (zero without CUCKOO_PROFILING)
+	inline const ProfileData& GetProfile() const { return m_profile; };
 
 	inline void SetNumberOfNests(unsigned int nests) { m_amount_of_nests = nests; };
 	inline void SetStopCriterian(StopCritearian stop_criterian) { m_stop_criterian = stop_criterian; };
@@ -117,16 +185,42 @@ public:
 	inline void SetAbandonProbability(double probability){ m_abandon_probability = probability; };
 	inline void SetStatisticsHandler(StatisticsHandler* handler) { m_statistics_handler = *handler; };
 	inline void SetMaxGenerations(unsigned int generations) { m_max_generations = generations; };
+	inline void SetExecutor(std::shared_ptr<Executor> executor) { m_executor = executor; };
+	void SetObjectiveFunction(ObjectiveFunction func);
+	inline void SetNumberOfThreads(unsigned int threads) { m_executor = Executor::Create(threads); };
+	//Fixed seed makes runs reproducible, without it each run takes new random seed
+	inline void SetSeed(std::uint64_t seed) { m_seed = seed; m_use_fixed_seed = true; };
+	inline void UseRandomSeed() { m_use_fixed_seed = false; };
+	inline void SetFlightBlockSize(unsigned int block_size) { m_flight_block_size = std::max(1u, block_size); };
+	//Flight changes only coordinates of few random blocks of block_size coordinates (block_size = 0 - all coordinates),
+	//candidates are evaluated by incremental function of objective, if it's set
+	void SetSubspaceFlights(unsigned int block_size, unsigned int blocks = 1);
+	inline void SetBudget(const SearchBudget& budget) { m_budget = budget; };
+	//Constraints besides bounds of objective (nullptr - without constraints)
+	void SetConstraints(std::shared_ptr<const ConstraintSet> constraints);
 
 	void UseLazyCuckoo();
 	void UseStandartCuckoo();
 
 protected:
 	unsigned int			m_amount_of_nests;
-	SetOfNests				m_nests;
+	Population				m_population;
+	Population				m_new_solutions;
+	Population				m_candidates;
+	Ranking					m_ranking;
+	std::vector<unsigned int>	m_targets;
+	std::vector<int>		m_proposals;
+	//Coordinates changed by i-flight are [i * subspace size, i * subspace size + m_changed_counts[i])
+	std::vector<unsigned int>	m_changed_coordinates;
+	std::vector<unsigned int>	m_changed_counts;
+	//Buffer of UpdateBestEver
+	std::vector<unsigned int>	m_best_rows;
 	Nest					m_best_ever;
-	Cuckoo*					m_cuckoo;
+	std::shared_ptr<Cuckoo>	m_cuckoo;
 	ObjectiveFunction		m_objective_function;
+	//Objective with checks of constraints, which is evaluated by search
+	ObjectiveFunction		m_evaluated_function;
+	std::shared_ptr<const ConstraintSet>	m_constraints;
 	StopCritearian			m_stop_criterian;
 	CompareFitness			m_cmp_fitness;
 	unsigned int			m_max_generations;
@@ -134,20 +228,61 @@ protected:
 
 	Lambda					m_lambda;
 	Step					m_step;
-	std::valarray<double>	m_delta_step;
+	std::valarray<double>	m_step_ratio;
+	std::valarray<double>	m_alpha;
+	std::vector<Bounds>		m_bounds;
 	double					m_abandon_probability;
 	bool					m_use_lazy_cuckoo;
 
 	StatisticsHandler		m_statistics_handler;
+	std::shared_ptr<Executor>	m_executor;
+	std::uint64_t			m_seed;
+	bool					m_use_fixed_seed;
+	unsigned int			m_flight_block_size;
+	unsigned int			m_subspace_block_size;
+	unsigned int			m_subspace_blocks;
+	ProfileData				m_profile;
+	SearchBudget			m_budget;
+	StopReason				m_stop_reason;
+	unsigned long long		m_evaluations;
+	std::chrono::steady_clock::time_point	m_start_time;
+	bool					m_minimize;
+	std::shared_ptr<CheckpointWriter>	m_checkpoint_writer;
+	unsigned int			m_checkpoint_interval;
+	unsigned int			m_stagnation;
+	double					m_stagnation_best;
 
 
 	void GenerateInitialPopulation();
+	void AllocateBuffers();
+	void SetDirection(bool minimize);
+	//Writes checkpoint after each m_checkpoint_interval generations
+	void ScheduleCheckpoint();
 	std::valarray<double> GetSolution();
+	virtual void StartSearch();
 	void AbandonNests();
+	void MakeFlights(unsigned int begin, unsigned int end);
+	void ReplaceNests(unsigned int begin, unsigned int end);
+	void UpdateBestEver(unsigned int begin, unsigned int end);
+	void EvaluateRows(Population& population, unsigned int begin, unsigned int end);
+	//Evaluates candidates of flights [begin, end) by incremental function
+	void EvaluateChanges(unsigned int begin, unsigned int end);
+	void CreateCuckoo();
 	void RankNests();
 	void RecalculateStep();
+	//Checks all limits, sets stop reason
+	bool IsStopped();
+	//Limits, which can end search inside of generation (evaluations and deadline)
+	bool IsBudgetExhausted();
+	//Number of rows (not more than rows), which evaluations fit into the rest of budget of evaluations
+	unsigned int GetBudgetedRows(unsigned int rows, unsigned int evaluations_per_row) const;
+	//Called after generation with new best ever nest
+	void UpdateStagnation();
 	void RecalculateLambdas();
 
+	enum RandomPhase { INITIALIZATION = 0, FLIGHT = 1, ABANDON = 2 };
+	RandomEngine GetRandomEngine(RandomPhase phase, unsigned int index) const;
+
 
 };
 
@@ -0,0 +1,97 @@
+#include "EvaluationCache.h"
+
+#include <cmath>
+#include <cstring>
+#include <algorithm>
+
+static inline std::uint64_t MixHash(std::uint64_t hash, std::uint64_t value)
+{
+	hash ^= value + 0x9E3779B97F4A7C15ull + (hash << 6) + (hash >> 2);
+	hash = (hash ^ (hash >> 30)) * 0xBF58476D1CE4E5B9ull;
+	return hash ^ (hash >> 31);
+};
+
+EvaluationCache::EvaluationCache(double tolerance, size_t capacity) :
+	m_tolerance(std::fabs(tolerance)), m_capacity(std::max<size_t>(capacity, SHARDS)), m_hits(0), m_misses(0)
+{
+	for (unsigned int i = 0; i < SHARDS; ++i)
+	{
+		m_shards.push_back(std::unique_ptr<Shard>(new Shard()));
+	}
+};
+
+std::uint64_t EvaluationCache::GetKey(const double* point, unsigned int dimensions) const
+{
+	std::uint64_t hash = dimensions;
+	for (unsigned int i = 0; i < dimensions; ++i)
+	{
+		std::uint64_t value;
+		if (m_tolerance > 0.0)
+		{
+			value = static_cast<std::uint64_t>(static_cast<std::int64_t>(std::floor(point[i] / m_tolerance)));
+		}
+		else
+		{
+			//-0.0 and 0.0 are equal points
+			const double coordinate = (point[i] == 0.0) ? 0.0 : point[i];
+			std::memcpy(&value, &coordinate, sizeof(value));
+		}
+		hash = MixHash(hash, value);
+	}
+	return hash;
+};
+
+bool EvaluationCache::IsSame(const double* ls, const double* rs, unsigned int dimensions) const
+{
+	for (unsigned int i = 0; i < dimensions; ++i)
+	{
+		if (m_tolerance > 0.0 ? std::fabs(ls[i] - rs[i]) > m_tolerance : ls[i] != rs[i])
+			return false;
+	}
+	return true;
+};
+
+bool EvaluationCache::Find(std::uint64_t key, const double* point, unsigned int dimensions, double& fitness)
+{
+	Shard& shard = GetShard(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	const auto range = shard.entries.equal_range(key);
+	for (auto entry = range.first; entry != range.second; ++entry)
+	{
+		if (entry->second.point.size() == dimensions && IsSame(entry->second.point.data(), point, dimensions))
+		{
+			fitness = entry->second.fitness;
+			return true;
+		}
+	}
+	return false;
+};
+
+void EvaluationCache::Insert(std::uint64_t key, const double* point, unsigned int dimensions, double fitness)
+{
+	Shard& shard = GetShard(key);
+	std::lock_guard<std::mutex> lock(shard.mutex);
+	if (shard.entries.size() >= m_capacity / SHARDS)
+	{
+		shard.entries.clear();
+	}
+	Entry entry = { std::vector<double>(point, point + dimensions), fitness };
+	shard.entries.emplace(key, std::move(entry));
+};
+
+void EvaluationCache::Clear()
+{
+	for (auto& shard : m_shards)
+	{
+		std::lock_guard<std::mutex> lock(shard->mutex);
+		shard->entries.clear();
+	}
+	m_hits = 0;
+	m_misses = 0;
+};
+
+double EvaluationCache::GetHitRate() const
+{
+	const unsigned long long calls = GetHits() + GetMisses();
+	return (calls == 0) ? 0.0 : double(GetHits()) / double(calls);
+};
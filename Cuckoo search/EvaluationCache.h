@@ -0,0 +1,74 @@
+/*
+	Description:
+		Cache of objective function values for expensive objectives.
+		Points are found by hash of coordinates. With tolerance = 0 only equal points
+		match (exact dedup). With tolerance > 0 coordinates are rounded to grid with
+		cell = tolerance, and point matches cached point from the same cell, if
+		all coordinates differ by no more than tolerance (points near borders of cells
+		can miss, but false hits are impossible).
+		Cache is divided into shards with own locks, so parallel evaluations
+		rarely wait for each other. When shard is full, it's cleared.
+		Hits and misses are counted: miss is real call of objective function.
+*/
+
+#ifndef EVALUATION_CACHE
+#define EVALUATION_CACHE
+
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <unordered_map>
+#include <cstdint>
+#include <cstddef>
+
+class EvaluationCache
+{
+public:
+	static const size_t DEFAULT_CAPACITY = 1 << 20;
+
+	EvaluationCache(double tolerance = 0.0, size_t capacity = DEFAULT_CAPACITY);
+
+	std::uint64_t GetKey(const double* point, unsigned int dimensions) const;
+	bool IsSame(const double* ls, const double* rs, unsigned int dimensions) const;
+	//key must be GetKey(point, dimensions)
+	bool Find(std::uint64_t key, const double* point, unsigned int dimensions, double& fitness);
+	void Insert(std::uint64_t key, const double* point, unsigned int dimensions, double fitness);
+	void Clear();
+
+	inline void AddHits(unsigned long long hits) { m_hits += hits; };
+	inline void AddMisses(unsigned long long misses) { m_misses += misses; };
+	inline unsigned long long GetHits() const { return m_hits.load(); };
+	inline unsigned long long GetMisses() const { return m_misses.load(); };
+	double GetHitRate() const;
+	inline double GetTolerance() const { return m_tolerance; };
+	inline size_t GetCapacity() const { return m_capacity; };
+
+private:
+	struct Entry
+	{
+		std::vector<double>	point;
+		double				fitness;
+	};
+
+	struct Shard
+	{
+		std::mutex									mutex;
+		std::unordered_multimap<std::uint64_t, Entry>	entries;
+	};
+
+	static const unsigned int SHARDS = 16;
+
+	double								m_tolerance;
+	size_t								m_capacity;
+	std::vector<std::unique_ptr<Shard>>	m_shards;
+	std::atomic<unsigned long long>		m_hits;
+	std::atomic<unsigned long long>		m_misses;
+
+	EvaluationCache(const EvaluationCache&) = delete;
+	EvaluationCache& operator=(const EvaluationCache&) = delete;
+
+	inline Shard& GetShard(std::uint64_t key) { return *m_shards[key % SHARDS]; };
+};
+
+#endif // !EVALUATION_CACHE
@@ -0,0 +1,196 @@
+#include "Executor.h"
+
+//Set while thread executes loop body, so nested loops don't wait for the pool
+static thread_local bool inside_parallel_loop = false;
+
+std::shared_ptr<Executor> Executor::Create(unsigned int threads)
+{
+	if (threads == 0)
+	{
+		threads = std::thread::hardware_concurrency();
+	}
+	if (threads <= 1)
+	{
+		return std::make_shared<SerialExecutor>();
+	}
+	return std::make_shared<WorkStealingExecutor>(threads);
+};
+
+void SerialExecutor::ParallelFor(unsigned int begin, unsigned int end, const LoopBody& body)
+{
+	for (unsigned int i = begin; i < end; ++i)
+	{
+		body(i);
+	}
+};
+
+WorkStealingExecutor::WorkStealingExecutor(unsigned int threads) :
+	m_pending(0), m_next_queue(0), m_stop(false)
+{
+	//Calling thread is a worker too
+	const unsigned int workers = (threads > 1) ? threads - 1 : 1;
+	for (unsigned int i = 0; i <= workers; ++i)
+	{
+		m_queues.push_back(std::unique_ptr<WorkerQueue>(new WorkerQueue()));
+	}
+	for (unsigned int i = 0; i < workers; ++i)
+	{
+		m_workers.push_back(std::thread(&WorkStealingExecutor::WorkerLoop, this, i));
+	}
+};
+
+WorkStealingExecutor::~WorkStealingExecutor()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+		m_stop = true;
+	}
+	m_wake.notify_all();
+	for (auto& worker : m_workers)
+	{
+		worker.join();
+	}
+};
+
+void WorkStealingExecutor::ParallelFor(unsigned int begin, unsigned int end, const LoopBody& body)
+{
+	if (begin >= end)
+		return;
+
+	const unsigned int size = end - begin;
+	if (inside_parallel_loop || size == 1)
+	{
+		for (unsigned int i = begin; i < end; ++i)
+		{
+			body(i);
+		}
+		return;
+	}
+
+	//Few chunks per thread give stealing room for unbalanced iterations
+	const unsigned int queues = static_cast<unsigned int>(m_queues.size());
+	const unsigned int chunk_size = std::max(1u, size / (4 * queues));
+
+	Job job;
+	job.body = &body;
+	job.remaining_chunks = (size + chunk_size - 1) / chunk_size;
+
+	unsigned int queue = m_next_queue.fetch_add(1) % queues;
+	for (unsigned int chunk_begin = begin; chunk_begin < end; chunk_begin += chunk_size)
+	{
+		Chunk chunk = { chunk_begin, std::min(end, chunk_begin + chunk_size), &job };
+		{
+			WorkerQueue& worker_queue = *m_queues[queue];
+			std::lock_guard<std::mutex> lock(worker_queue.mutex);
+			if (worker_queue.IsEmpty())
+			{
+				worker_queue.chunks.clear();
+				worker_queue.head = 0;
+			}
+			worker_queue.chunks.push_back(chunk);
+		}
+		++m_pending;
+		queue = (queue + 1) % queues;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_sleep_mutex);
+	}
+	m_wake.notify_all();
+
+	//Help the pool while own job isn't finished
+	const unsigned int own_queue = queues - 1;
+	Chunk chunk;
+	while (true)
+	{
+		{
+			std::lock_guard<std::mutex> lock(job.mutex);
+			if (job.remaining_chunks == 0)
+				break;
+		}
+		if (!TryGetChunk(own_queue, chunk))
+			break;
+		Execute(chunk);
+	}
+
+	std::unique_lock<std::mutex> lock(job.mutex);
+	job.done.wait(lock, [&]() { return job.remaining_chunks == 0; });
+	if (job.error)
+	{
+		std::rethrow_exception(job.error);
+	}
+};
+
+void WorkStealingExecutor::WorkerLoop(unsigned int index)
+{
+	Chunk chunk;
+	while (true)
+	{
+		if (TryGetChunk(index, chunk))
+		{
+			Execute(chunk);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(m_sleep_mutex);
+		m_wake.wait(lock, [&]() { return m_stop || m_pending.load() > 0; });
+		if (m_stop && m_pending.load() == 0)
+			return;
+	}
+};
+
+bool WorkStealingExecutor::TryGetChunk(unsigned int own_queue, Chunk& chunk)
+{
+	if (m_pending.load() == 0)
+		return false;
+
+	const unsigned int queues = static_cast<unsigned int>(m_queues.size());
+	for (unsigned int i = 0; i < queues; ++i)
+	{
+		WorkerQueue& queue = *m_queues[(own_queue + i) % queues];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.IsEmpty())
+			continue;
+		//Own queue is used as stack (hot data in cache), other queues are robbed from front
+		if (i == 0)
+		{
+			chunk = queue.chunks.back();
+			queue.chunks.pop_back();
+		}
+		else
+		{
+			chunk = queue.chunks[queue.head++];
+		}
+		--m_pending;
+		return true;
+	}
+	return false;
+};
+
+void WorkStealingExecutor::Execute(const Chunk& chunk)
+{
+	Job& job = *chunk.job;
+	std::exception_ptr error;
+	const bool was_inside = inside_parallel_loop;
+	inside_parallel_loop = true;
+	try
+	{
+		for (unsigned int i = chunk.begin; i < chunk.end; ++i)
+		{
+			(*job.body)(i);
+		}
+	}
+	catch (...)
+	{
+		error = std::current_exception();
+	}
+	inside_parallel_loop = was_inside;
+
+	std::lock_guard<std::mutex> lock(job.mutex);
+	if (error && !job.error)
+	{
+		job.error = error;
+	}
+	if (--job.remaining_chunks == 0)
+	{
+		job.done.notify_all();
+	}
+};
@@ -0,0 +1,118 @@
+/*
+	Description:
+		Executors run parallel loops of the search engine.
+		Executor - interface, which has to run body(i) for each i in [begin, end).
+		SerialExecutor - runs all iterations on calling thread.
+		WorkStealingExecutor - thread pool. Each loop is splitted into chunks which are
+		distributed between queues of workers. Worker takes chunks from back of own queue
+		and steals chunks from front of queues of other workers when own queue is empty.
+		Calling thread doesn't wait passively, it executes chunks too.
+		Nested ParallelFor (called from loop body) runs serially.
+		Loop doesn't allocate memory: body is passed by reference (LoopBody doesn't copy
+		callable object) and queues keep memory of chunks between loops.
+*/
+
+#ifndef EXECUTOR
+#define EXECUTOR
+
+#include <functional>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <algorithm>
+
+//Reference to callable object body(i), which has to live until ParallelFor returns
+class LoopBody
+{
+public:
+	template <typename Body>
+	LoopBody(const Body& body) :
+		m_body(&body), m_call(&Call<Body>) {};
+
+	inline void operator()(unsigned int i) const { m_call(m_body, i); };
+
+private:
+	const void*	m_body;
+	void		(*m_call)(const void* body, unsigned int i);
+
+	template <typename Body>
+	static void Call(const void* body, unsigned int i) { (*static_cast<const Body*>(body))(i); };
+};
+
+class Executor
+{
+public:
+	virtual ~Executor() {};
+	virtual void ParallelFor(unsigned int begin, unsigned int end, const LoopBody& body) = 0;
+	virtual unsigned int GetNumberOfThreads() const = 0;
+
+	//threads = 0 - use all hardware threads, threads = 1 - serial executor
+	static std::shared_ptr<Executor> Create(unsigned int threads = 0);
+};
+
+class SerialExecutor : public Executor
+{
+public:
+	SerialExecutor() {};
+	virtual void ParallelFor(unsigned int begin, unsigned int end, const LoopBody& body);
+	inline virtual unsigned int GetNumberOfThreads() const { return 1; };
+};
+
+class WorkStealingExecutor : public Executor
+{
+public:
+	WorkStealingExecutor(unsigned int threads = std::thread::hardware_concurrency());
+	virtual ~WorkStealingExecutor();
+	virtual void ParallelFor(unsigned int begin, unsigned int end, const LoopBody& body);
+	inline virtual unsigned int GetNumberOfThreads() const { return static_cast<unsigned int>(m_workers.size()) + 1; };
+
+private:
+	struct Job
+	{
+		const LoopBody*			body;
+		unsigned int			remaining_chunks;
+		std::exception_ptr		error;
+		std::mutex				mutex;
+		std::condition_variable	done;
+	};
+
+	struct Chunk
+	{
+		unsigned int	begin;
+		unsigned int	end;
+		Job*			job;
+	};
+
+	//Chunks [head, size) are in queue, memory of vector is kept when queue becomes empty
+	struct WorkerQueue
+	{
+		std::mutex			mutex;
+		std::vector<Chunk>	chunks;
+		size_t				head;
+
+		WorkerQueue() :
+			head(0) { chunks.reserve(64); };
+		inline bool IsEmpty() const { return head == chunks.size(); };
+	};
+
+	std::vector<std::thread>					m_workers;
+	std::vector<std::unique_ptr<WorkerQueue>>	m_queues;
+	std::atomic<unsigned int>					m_pending;
+	std::atomic<unsigned int>					m_next_queue;
+	std::mutex									m_sleep_mutex;
+	std::condition_variable						m_wake;
+	bool										m_stop;
+
+	WorkStealingExecutor(const WorkStealingExecutor&) = delete;
+	WorkStealingExecutor& operator=(const WorkStealingExecutor&) = delete;
+
+	void WorkerLoop(unsigned int index);
+	bool TryGetChunk(unsigned int own_queue, Chunk& chunk);
+	void Execute(const Chunk& chunk);
+};
+
+#endif // !EXECUTOR
@@ -0,0 +1,541 @@
+#include "ExperimentRunner.h"
+#include "OnlineStatistics.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <limits>
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <stdexcept>
+#include <cstdio>
+#include <cctype>
+
+#ifdef _WIN32
+#include <direct.h>
+#else
+#include <sys/stat.h>
+#include <sys/types.h>
+#endif
+
+static const char* RESULTS_HEADER = "trial,seed,best_fitness,generations,stop_reason,evaluations,wall_seconds,cpu_seconds,evaluations_per_second";
+
+static std::string Trim(const std::string& text)
+{
+	const size_t begin = text.find_first_not_of(" \t\r\n");
+	if (begin == std::string::npos)
+		return std::string();
+	const size_t end = text.find_last_not_of(" \t\r\n");
+	return text.substr(begin, end - begin + 1);
+};
+
+static std::vector<std::string> Split(const std::string& text, char separator)
+{
+	std::vector<std::string> items;
+	std::stringstream stream(text);
+	std::string item;
+	while (std::getline(stream, item, separator))
+	{
+		items.push_back(Trim(item));
+	}
+	return items;
+};
+
+static void MakeDirectory(const std::string& directory)
+{
+	//Existing directory is not an error
+#ifdef _WIN32
+	_mkdir(directory.c_str());
+#else
+	mkdir(directory.c_str(), 0755);
+#endif
+};
+
+//Temporary file is renamed, so file with results is always complete
+static void WriteFile(const std::string& file_path, const std::string& content)
+{
+	const std::string temporary_path = file_path + ".tmp";
+	{
+		std::ofstream file(temporary_path);
+		if (!file)
+			throw std::runtime_error("Can't create " + temporary_path + "\n");
+		file << content;
+	}
+	std::remove(file_path.c_str());
+	if (std::rename(temporary_path.c_str(), file_path.c_str()) != 0)
+		throw std::runtime_error("Can't write " + file_path + "\n");
+};
+
+//File names consist of letters, digits, '-' and '_'
+static std::string GetFileName(const std::string& name)
+{
+	std::string file_name = name;
+	for (char& symbol : file_name)
+	{
+		if (!std::isalnum(static_cast<unsigned char>(symbol)) && symbol != '-' && symbol != '_')
+		{
+			symbol = '_';
+		}
+	}
+	return file_name;
+};
+
+static double ParseDouble(const std::string& value, const std::string& key)
+{
+	try
+	{
+		size_t size;
+		const double result = std::stod(value, &size);
+		if (size == value.size())
+			return result;
+	}
+	catch (std::exception&)
+	{
+	}
+	throw std::runtime_error("Wrong value of " + key + ": " + value + "\n");
+};
+
+static unsigned long long ParseUnsigned(const std::string& value, const std::string& key)
+{
+	try
+	{
+		size_t size;
+		const unsigned long long result = std::stoull(value, &size);
+		if (size == value.size() && value[0] != '-')
+			return result;
+	}
+	catch (std::exception&)
+	{
+	}
+	throw std::runtime_error("Wrong value of " + key + ": " + value + "\n");
+};
+
+static bool ParseBool(const std::string& value, const std::string& key)
+{
+	if (value == "true" || value == "1")
+		return true;
+	if (value == "false" || value == "0")
+		return false;
+	throw std::runtime_error("Wrong value of " + key + ": " + value + "\n");
+};
+
+//Returns false for unknown parameter
+static bool SetParameter(ExperimentParameters& parameters, const std::string& key, const std::string& value)
+{
+	if (key == "nests")
+		parameters.nests = static_cast<unsigned int>(ParseUnsigned(value, key));
+	else if (key == "min_step")
+		parameters.min_step = ParseDouble(value, key);
+	else if (key == "max_step")
+		parameters.max_step = ParseDouble(value, key);
+	else if (key == "min_lambda")
+		parameters.min_lambda = ParseDouble(value, key);
+	else if (key == "max_lambda")
+		parameters.max_lambda = ParseDouble(value, key);
+	else if (key == "abandon_probability")
+		parameters.abandon_probability = ParseDouble(value, key);
+	else if (key == "generations")
+		parameters.generations = static_cast<unsigned int>(ParseUnsigned(value, key));
+	else if (key == "lazy_cuckoo")
+		parameters.lazy_cuckoo = ParseBool(value, key);
+	else if (key == "max_evaluations")
+		parameters.max_evaluations = ParseUnsigned(value, key);
+	else if (key == "subspace_block_size")
+		parameters.subspace_block_size = static_cast<unsigned int>(ParseUnsigned(value, key));
+	else if (key == "subspace_blocks")
+		parameters.subspace_blocks = static_cast<unsigned int>(ParseUnsigned(value, key));
+	else
+		return false;
+	return true;
+};
+
+ExperimentParameters::ExperimentParameters() :
+	name("default"), nests(200), min_step(1e-6), max_step(1e-2), min_lambda(0.3), max_lambda(1.99),
+	abandon_probability(0.25), generations(1000), lazy_cuckoo(false), max_evaluations(0),
+	subspace_block_size(0), subspace_blocks(1)
+{
+};
+
+std::string ExperimentParameters::GetSignature() const
+{
+	std::ostringstream signature;
+	signature << std::setprecision(std::numeric_limits<double>::max_digits10);
+	signature << "nests=" << nests << ";min_step=" << min_step << ";max_step=" << max_step <<
+		";min_lambda=" << min_lambda << ";max_lambda=" << max_lambda << ";abandon_probability=" << abandon_probability <<
+		";generations=" << generations << ";lazy_cuckoo=" << lazy_cuckoo << ";max_evaluations=" << max_evaluations <<
+		";subspace_block_size=" << subspace_block_size << ";subspace_blocks=" << subspace_blocks;
+	return signature.str();
+};
+
+ExperimentRunner::ExperimentRunner() :
+	m_output_directory("experiment"), m_trials(1), m_base_seed(1), m_threads(0), m_parameter_sets(1)
+{
+};
+
+void ExperimentRunner::RegisterFunction(const std::string& name, const ObjectiveFunction& function)
+{
+	m_registered_functions[name] = function;
+};
+
+void ExperimentRunner::Load(const std::string& file_path)
+{
+	std::ifstream file(file_path);
+	if (!file)
+		throw std::runtime_error("Can't open experiment " + file_path + "\n");
+
+	ExperimentParameters defaults;
+	std::vector<ExperimentParameters> parameter_sets;
+	std::string line;
+	unsigned int line_number = 0;
+	while (std::getline(file, line))
+	{
+		++line_number;
+		const std::string where = file_path + ":" + std::to_string(line_number) + ": ";
+		line = Trim(line.substr(0, line.find('#')));
+		if (line.empty())
+			continue;
+
+		if (line[0] == '[')
+		{
+			if (line.back() != ']')
+				throw std::runtime_error(where + "section isn't closed\n");
+			parameter_sets.push_back(defaults);
+			parameter_sets.back().name = Trim(line.substr(1, line.size() - 2));
+			continue;
+		}
+
+		const size_t separator = line.find('=');
+		if (separator == std::string::npos)
+			throw std::runtime_error(where + "'key = value' is expected\n");
+		const std::string key = Trim(line.substr(0, separator));
+		const std::string value = Trim(line.substr(separator + 1));
+		try
+		{
+			ExperimentParameters& parameters = parameter_sets.empty() ? defaults : parameter_sets.back();
+			if (SetParameter(parameters, key, value))
+				continue;
+			if (!parameter_sets.empty())
+				throw std::runtime_error("unknown parameter " + key + "\n");
+
+			if (key == "output")
+				m_output_directory = value;
+			else if (key == "trials")
+				m_trials = static_cast<unsigned int>(ParseUnsigned(value, key));
+			else if (key == "base_seed")
+				m_base_seed = ParseUnsigned(value, key);
+			else if (key == "threads")
+				m_threads = static_cast<unsigned int>(ParseUnsigned(value, key));
+			else if (key == "functions")
+			{
+				m_functions = Split(value, ',');
+				for (const std::string& function : m_functions)
+				{
+					if (m_registered_functions.find(function) == m_registered_functions.end())
+						throw std::runtime_error("unknown function " + function + "\n");
+				}
+			}
+			else if (key == "dimensions")
+			{
+				m_dimensions.clear();
+				for (const std::string& dimensions : Split(value, ','))
+				{
+					m_dimensions.push_back(static_cast<unsigned int>(ParseUnsigned(dimensions, key)));
+				}
+			}
+			else
+				throw std::runtime_error("unknown setting " + key + "\n");
+		}
+		catch (std::exception& e)
+		{
+			throw std::runtime_error(where + e.what());
+		}
+	}
+	if (parameter_sets.empty())
+	{
+		parameter_sets.push_back(defaults);
+	}
+	m_parameter_sets = parameter_sets;
+};
+
+std::vector<ExperimentConfiguration> ExperimentRunner::GetConfigurations() const
+{
+	std::vector<ExperimentConfiguration> configurations;
+	for (const std::string& function : m_functions)
+	{
+		//Without dimensions function keeps its own number of dimensions
+		const std::vector<unsigned int> dimensions = m_dimensions.empty() ?
+			std::vector<unsigned int>(1, m_registered_functions.at(function).GetNumberOfDimensions()) : m_dimensions;
+		for (unsigned int dimension : dimensions)
+		{
+			for (const ExperimentParameters& parameters : m_parameter_sets)
+			{
+				configurations.push_back({ function, dimension, parameters });
+			}
+		}
+	}
+	return configurations;
+};
+
+CuckooSearch ExperimentRunner::CreateSearch(const ExperimentConfiguration& configuration) const
+{
+	const ExperimentParameters& parameters = configuration.parameters;
+	ObjectiveFunction function = m_registered_functions.at(configuration.function);
+	function.SetDimensions(configuration.dimensions);
+
+	CuckooSearch cuckoo_search(function, parameters.nests, { parameters.min_step, parameters.max_step },
+		{ parameters.min_lambda, parameters.max_lambda }, parameters.abandon_probability, parameters.generations);
+	//Jobs run in parallel, search of each job runs on its thread
+	cuckoo_search.SetNumberOfThreads(1);
+	if (parameters.lazy_cuckoo)
+	{
+		cuckoo_search.UseLazyCuckoo();
+	}
+	if (parameters.max_evaluations > 0)
+	{
+		SearchBudget budget;
+		budget.SetMaxEvaluations(parameters.max_evaluations);
+		cuckoo_search.SetBudget(budget);
+	}
+	if (parameters.subspace_block_size > 0)
+	{
+		cuckoo_search.SetSubspaceFlights(parameters.subspace_block_size, parameters.subspace_blocks);
+	}
+	return cuckoo_search;
+};
+
+std::string ExperimentRunner::GetResultPath(const ExperimentConfiguration& configuration) const
+{
+	return m_output_directory + "/" + GetFileName(configuration.function + "_d" + std::to_string(configuration.dimensions) +
+		"_" + configuration.parameters.name) + ".csv";
+};
+
+//Results depend on parameters, number of trials and seed
+static std::string GetResultSignature(const ExperimentConfiguration& configuration, unsigned int trials, std::uint64_t base_seed)
+{
+	return "# " + configuration.function + ";dimensions=" + std::to_string(configuration.dimensions) + ";trials=" +
+		std::to_string(trials) + ";base_seed=" + std::to_string(base_seed) + ";" + configuration.parameters.GetSignature();
+};
+
+bool ExperimentRunner::ReadTrials(const ExperimentConfiguration& configuration, std::vector<TrialResult>& results) const
+{
+	std::ifstream file(GetResultPath(configuration));
+	std::string line;
+	if (!file || !std::getline(file, line) || line != GetResultSignature(configuration, m_trials, m_base_seed))
+		return false;
+	if (!std::getline(file, line) || line != RESULTS_HEADER)
+		return false;
+
+	results.clear();
+	while (std::getline(file, line) && !line.empty())
+	{
+		const std::vector<std::string> values = Split(line, ',');
+		if (values.size() != 9)
+			return false;
+		try
+		{
+			TrialResult result = TrialResult();
+			result.trial = static_cast<unsigned int>(std::stoul(values[0]));
+			result.seed = std::stoull(values[1]);
+			result.best_fitness = std::stod(values[2]);
+			result.generations = static_cast<unsigned int>(std::stoul(values[3]));
+			result.stop_reason = StopReason::NONE;
+			for (StopReason reason : { StopReason::MAX_GENERATIONS, StopReason::MAX_EVALUATIONS, StopReason::DEADLINE,
+				StopReason::TARGET_FITNESS, StopReason::STAGNATION, StopReason::STOP_CRITERIAN })
+			{
+				if (values[4] == GetStopReasonName(reason))
+				{
+					result.stop_reason = reason;
+				}
+			}
+			result.evaluations = std::stoull(values[5]);
+			result.wall_seconds = std::stod(values[6]);
+			result.cpu_seconds = std::stod(values[7]);
+			result.evaluations_per_second = std::stod(values[8]);
+			results.push_back(result);
+		}
+		catch (std::exception&)
+		{
+			return false;
+		}
+	}
+	return results.size() == m_trials;
+};
+
+void ExperimentRunner::WriteTrials(const ExperimentConfiguration& configuration, const std::vector<TrialResult>& results) const
+{
+	std::ostringstream content;
+	content << std::setprecision(std::numeric_limits<double>::max_digits10);
+	content << GetResultSignature(configuration, m_trials, m_base_seed) << "\n" << RESULTS_HEADER << "\n";
+	for (const TrialResult& result : results)
+	{
+		content << result.trial << "," << result.seed << "," << result.best_fitness << "," << result.generations << "," <<
+			GetStopReasonName(result.stop_reason) << "," << result.evaluations << "," << result.wall_seconds << "," <<
+			result.cpu_seconds << "," << result.evaluations_per_second << "\n";
+	}
+	WriteFile(GetResultPath(configuration), content.str());
+};
+
+ExperimentSummary ExperimentRunner::Summarize(const ExperimentConfiguration& configuration, const std::vector<TrialResult>& results) const
+{
+	ExperimentSummary summary;
+	summary.configuration = configuration;
+	summary.trials = static_cast<unsigned int>(results.size());
+	summary.is_skipped = false;
+
+	std::vector<double> fitness;
+	RunningStatistics fitness_statistics;
+	RunningStatistics evaluations;
+	RunningStatistics wall_seconds;
+	for (const TrialResult& result : results)
+	{
+		fitness.push_back(result.best_fitness);
+		fitness_statistics.Add(result.best_fitness);
+		evaluations.Add(double(result.evaluations));
+		wall_seconds.Add(result.wall_seconds);
+	}
+	std::sort(fitness.begin(), fitness.end());
+	const size_t middle = fitness.size() / 2;
+	summary.best = fitness.empty() ? 0.0 : fitness.front();
+	summary.worst = fitness.empty() ? 0.0 : fitness.back();
+	summary.median = fitness.empty() ? 0.0 : ((fitness.size() % 2) ? fitness[middle] : (fitness[middle - 1] + fitness[middle]) / 2.0);
+	summary.mean = fitness_statistics.GetMean();
+	summary.std_deviation = fitness_statistics.GetStdDeviation();
+	summary.mean_evaluations = evaluations.GetMean();
+	summary.mean_wall_seconds = wall_seconds.GetMean();
+	return summary;
+};
+
+const std::vector<ExperimentSummary>& ExperimentRunner::Run()
+{
+	const std::vector<ExperimentConfiguration> configurations = GetConfigurations();
+	MakeDirectory(m_output_directory);
+
+	std::vector<std::vector<TrialResult>> results(configurations.size());
+	std::vector<std::unique_ptr<TrialHarness>> harnesses(configurations.size());
+	std::vector<unsigned int> remaining_trials(configurations.size(), 0);
+	std::vector<bool> is_failed(configurations.size(), false);
+	std::vector<bool> has_summary(configurations.size(), false);
+	std::vector<ExperimentSummary> summaries(configurations.size());
+
+	//Job - one trial of configuration
+	struct Job
+	{
+		unsigned int	configuration;
+		unsigned int	trial;
+		double			cost;
+	};
+	std::vector<Job> jobs;
+	for (unsigned int i = 0; i < configurations.size(); ++i)
+	{
+		if (ReadTrials(configurations[i], results[i]))
+		{
+			summaries[i] = Summarize(configurations[i], results[i]);
+			summaries[i].is_skipped = true;
+			has_summary[i] = true;
+			continue;
+		}
+		const ExperimentParameters& parameters = configurations[i].parameters;
+		harnesses[i].reset(new TrialHarness(CreateSearch(configurations[i]), m_trials, m_base_seed));
+		results[i].assign(m_trials, TrialResult());
+		remaining_trials[i] = m_trials;
+		const double cost = double(parameters.nests) * parameters.generations * configurations[i].dimensions * (parameters.lazy_cuckoo ? 2.0 : 1.0);
+		for (unsigned int trial = 0; trial < m_trials; ++trial)
+		{
+			jobs.push_back({ i, trial, cost });
+		}
+	}
+	//The longest jobs go first, so short jobs fill threads at the end
+	std::stable_sort(jobs.begin(), jobs.end(), [](const Job& ls, const Job& rs) { return ls.cost > rs.cost; });
+	std::cout << configurations.size() << " configurations, " << jobs.size() << " trials to run\n";
+
+	std::mutex mutex;
+	std::atomic<size_t> next_job(0);
+	size_t completed_jobs = 0;
+	const unsigned int threads = std::max(1u, std::min(static_cast<unsigned int>(jobs.size()),
+		(m_threads == 0) ? std::thread::hardware_concurrency() : m_threads));
+	std::shared_ptr<Executor> executor = Executor::Create(threads);
+	executor->ParallelFor(0, threads, [&](unsigned int)
+	{
+		for (size_t index = next_job++; index < jobs.size(); index = next_job++)
+		{
+			const Job& job = jobs[index];
+			const ExperimentConfiguration& configuration = configurations[job.configuration];
+			TrialResult result = TrialResult();
+			std::string error;
+			try
+			{
+				result = harnesses[job.configuration]->RunTrial(job.trial, true);
+			}
+			catch (std::exception& e)
+			{
+				error = e.what();
+			}
+
+			std::lock_guard<std::mutex> lock(mutex);
+			++completed_jobs;
+			std::cout << "[" << completed_jobs << "/" << jobs.size() << "] " << configuration.function << ", " <<
+				configuration.dimensions << " dimensions, " << configuration.parameters.name << ", trial #" << job.trial + 1 << ": ";
+			if (error.empty())
+			{
+				results[job.configuration][job.trial] = result;
+				std::cout << result.best_fitness << " (" << result.wall_seconds << " s)\n";
+			}
+			else
+			{
+				is_failed[job.configuration] = true;
+				std::cout << "error: " << error;
+			}
+			if (--remaining_trials[job.configuration] == 0 && !is_failed[job.configuration])
+			{
+				try
+				{
+					WriteTrials(configuration, results[job.configuration]);
+				}
+				catch (std::exception& e)
+				{
+					std::cout << e.what();
+				}
+				summaries[job.configuration] = Summarize(configuration, results[job.configuration]);
+				has_summary[job.configuration] = true;
+				harnesses[job.configuration].reset();
+			}
+		}
+	});
+
+	m_summaries.clear();
+	for (unsigned int i = 0; i < configurations.size(); ++i)
+	{
+		if (has_summary[i])
+		{
+			m_summaries.push_back(summaries[i]);
+		}
+	}
+	std::ostringstream table;
+	WriteResults(table);
+	WriteFile(m_output_directory + "/results.csv", table.str());
+	return m_summaries;
+};
+
+void ExperimentRunner::WriteResults(std::ostream& o_stream) const
+{
+	o_stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+	o_stream << "function,dimensions,parameter_set,nests,min_step,max_step,min_lambda,max_lambda,abandon_probability,generations," <<
+		"lazy_cuckoo,max_evaluations,subspace_block_size,subspace_blocks,trials,skipped,best,median,mean,std_deviation,worst," <<
+		"mean_evaluations,mean_wall_seconds\n";
+	for (const ExperimentSummary& summary : m_summaries)
+	{
+		const ExperimentConfiguration& configuration = summary.configuration;
+		const ExperimentParameters& parameters = configuration.parameters;
+		o_stream << "\"" << configuration.function << "\"," << configuration.dimensions << ",\"" << parameters.name << "\"," <<
+			parameters.nests << "," << parameters.min_step << "," << parameters.max_step << "," << parameters.min_lambda << "," <<
+			parameters.max_lambda << "," << parameters.abandon_probability << "," << parameters.generations << "," <<
+			(parameters.lazy_cuckoo ? "true" : "false") << "," << parameters.max_evaluations << "," << parameters.subspace_block_size << "," <<
+			parameters.subspace_blocks << "," << summary.trials << "," << (summary.is_skipped ? "true" : "false") << "," <<
+			summary.best << "," << summary.median << "," << summary.mean << "," << summary.std_deviation << "," << summary.worst << "," <<
+			summary.mean_evaluations << "," << summary.mean_wall_seconds << "\n";
+	}
+};
@@ -0,0 +1,124 @@
+/*
+	Description:
+		Experiment runner: runs grid of configurations (functions x dimensions x parameter
+		sets) with several trials each, instead of constants of Test.cpp, which require rebuild.
+		Grid is read from experiment file:
+			# comment
+			output = sweep				directory of results
+			trials = 10
+			base_seed = 1
+			threads = 0					0 - all hardware threads
+			functions = sphere, rastrigin
+			dimensions = 10, 30
+			nests = 200					parameters before first section are defaults of all sets
+			[default]					parameter set, which takes defaults
+			[short step]
+			max_step = 1e-3
+		Parameters: nests, min_step, max_step, min_lambda, max_lambda, abandon_probability,
+		generations, lazy_cuckoo, max_evaluations, subspace_block_size, subspace_blocks.
+		File without sections has one parameter set "default".
+		All trials of all configurations are jobs of one queue: worker on each thread takes
+		the next job (the longest jobs go first), search of job runs on thread of worker.
+		Results of configuration are written to own CSV file, when its last trial finishes.
+		Configuration, which has file with results for the same parameters and
+		number of trials, is skipped, so interrupted experiment is continued by the next run.
+		At the end consolidated table (results.csv) has one row of statistics for each configuration.
+*/
+
+#ifndef EXPERIMENT_RUNNER
+#define EXPERIMENT_RUNNER
+
+#include "CuckooSearch.h"
+#include "TrialHarness.h"
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+#include <cstdint>
+
+struct ExperimentParameters
+{
+	std::string			name;
+	unsigned int		nests;
+	double				min_step;
+	double				max_step;
+	double				min_lambda;
+	double				max_lambda;
+	double				abandon_probability;
+	unsigned int		generations;
+	bool				lazy_cuckoo;
+	unsigned long long	max_evaluations;
+	unsigned int		subspace_block_size;
+	unsigned int		subspace_blocks;
+
+	ExperimentParameters();
+	//All values, results are reused only for the same signature
+	std::string GetSignature() const;
+};
+
+struct ExperimentConfiguration
+{
+	std::string				function;
+	unsigned int			dimensions;
+	ExperimentParameters	parameters;
+};
+
+struct ExperimentSummary
+{
+	ExperimentConfiguration	configuration;
+	unsigned int			trials;
+	bool					is_skipped;
+	double					best;
+	double					median;
+	double					mean;
+	double					std_deviation;
+	double					worst;
+	double					mean_evaluations;
+	double					mean_wall_seconds;
+};
+
+class ExperimentRunner
+{
+public:
+	ExperimentRunner();
+
+	//Functions, which can be used in experiment file
+	void RegisterFunction(const std::string& name, const ObjectiveFunction& function);
+	//Reads grid and settings from experiment file
+	void Load(const std::string& file_path);
+	//Runs configurations, which don't have results, and writes results.csv
+	const std::vector<ExperimentSummary>& Run();
+	void WriteResults(std::ostream& o_stream) const;
+
+	inline void SetOutputDirectory(const std::string& directory) { m_output_directory = directory; };
+	inline void SetTrials(unsigned int trials) { m_trials = trials; };
+	inline void SetBaseSeed(std::uint64_t seed) { m_base_seed = seed; };
+	inline void SetThreads(unsigned int threads) { m_threads = threads; };
+	inline void SetFunctions(const std::vector<std::string>& functions) { m_functions = functions; };
+	inline void SetDimensions(const std::vector<unsigned int>& dimensions) { m_dimensions = dimensions; };
+	inline void SetParameterSets(const std::vector<ExperimentParameters>& parameter_sets) { m_parameter_sets = parameter_sets; };
+
+	std::vector<ExperimentConfiguration> GetConfigurations() const;
+	inline const std::vector<ExperimentSummary>& GetSummaries() const { return m_summaries; };
+
+private:
+	std::map<std::string, ObjectiveFunction>	m_registered_functions;
+	std::string							m_output_directory;
+	unsigned int						m_trials;
+	std::uint64_t						m_base_seed;
+	unsigned int						m_threads;
+	std::vector<std::string>			m_functions;
+	std::vector<unsigned int>			m_dimensions;
+	std::vector<ExperimentParameters>	m_parameter_sets;
+	std::vector<ExperimentSummary>		m_summaries;
+
+	CuckooSearch CreateSearch(const ExperimentConfiguration& configuration) const;
+	std::string GetResultPath(const ExperimentConfiguration& configuration) const;
+	//Reads results of configuration, returns false if there are no complete results for the same parameters
+	bool ReadTrials(const ExperimentConfiguration& configuration, std::vector<TrialResult>& results) const;
+	void WriteTrials(const ExperimentConfiguration& configuration, const std::vector<TrialResult>& results) const;
+	ExperimentSummary Summarize(const ExperimentConfiguration& configuration, const std::vector<TrialResult>& results) const;
+};
+
+#endif // !EXPERIMENT_RUNNER
@@ -1,28 +1,194 @@
 #include "FunctionHelper.h"
 
-ObjectiveFunction::ObjectiveFunction(std::function<double(std::valarray<double>)> function, unsigned int dimensions, Bounds bounds, std::string function_name) :
+ObjectiveFunction::ObjectiveFunction(PointFunction function, unsigned int dimensions, Bounds bounds, std::string function_name) :
 	m_function(function), m_dimensions(dimensions), m_function_name(function_name)
 {
 	m_bounds = std::vector<Bounds>(m_dimensions, bounds);
 };
 
-ObjectiveFunction::ObjectiveFunction(std::function<double(std::valarray<double>)> function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name):
+ObjectiveFunction::ObjectiveFunction(PointFunction function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name):
 	m_function(function), m_dimensions(dimensions), m_bounds(bounds), m_function_name(function_name) { };
 
+ObjectiveFunction::ObjectiveFunction(BatchFunction function, unsigned int dimensions, Bounds bounds, std::string function_name) :
+	m_batch_function(function), m_dimensions(dimensions), m_function_name(function_name)
+{
+	m_bounds = std::vector<Bounds>(m_dimensions, bounds);
+};
+
+ObjectiveFunction::ObjectiveFunction(BatchFunction function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name) :
+	m_batch_function(function), m_dimensions(dimensions), m_bounds(bounds), m_function_name(function_name) { };
+
 double ObjectiveFunction::operator()(const std::valarray<double>& args) const
 {
-	if (args.size() != m_dimensions)
-		throw std::exception("Dimensions in current function and amount of args isn't equal\n");
+	CheckDimensions(args.size());
+
+	//Evaluate chooses cache, batch or point function
+	double fitness;
+	Evaluate(&args[0], 1, m_dimensions, &fitness);
+	return fitness;
+};
+
+double ObjectiveFunction::operator()(const double* args) const
+{
+	double fitness;
+	Evaluate(args, 1, m_dimensions, &fitness);
+	return fitness;
+};
 
-	if (args.size() != m_bounds.size())
-		throw std::exception("The number of bounds isn't equal amount of args\n");
+void ObjectiveFunction::Evaluate(const double* points, unsigned int count, unsigned int stride, double* fitness) const
+{
+	CheckDimensions(m_dimensions);
 
-	return m_function(args);
+	if (m_cache)
+	{
+		EvaluateCached(points, count, stride, fitness);
+	}
+	else
+	{
+		EvaluateBlock(points, count, stride, fitness);
+	}
+};
+
+double ObjectiveFunction::EvaluateChange(const double* point, const double* previous_point, double previous_fitness,
+	const unsigned int* changed, unsigned int count) const
+{
+	if (!m_incremental_function || count == m_dimensions)
+		return (*this)(point);
+	return m_incremental_function(point, previous_point, previous_fitness, changed, count);
+};
+
+void ObjectiveFunction::EnableCache(double tolerance, size_t capacity)
+{
+	m_cache = std::make_shared<EvaluationCache>(tolerance, capacity);
 };
 
 void ObjectiveFunction::SetDimensions(unsigned int new_dimension)
 {
+	if (new_dimension != m_dimensions)
+	{
+		ResetCache();
+	}
 	m_dimensions = new_dimension;
 	m_bounds = std::vector<Bounds>(m_dimensions, m_bounds[0]);
 };
 
+void ObjectiveFunction::CheckDimensions(size_t size) const
+{
+	if (size != m_dimensions)
+		throw std::runtime_error("Dimensions in current function and amount of args isn't equal\n");
+
+	if (size != m_bounds.size())
+		throw std::runtime_error("The number of bounds isn't equal amount of args\n");
+};
+
+void ObjectiveFunction::EvaluateBlock(const double* points, unsigned int count, unsigned int stride, double* fitness) const
+{
+	if (m_batch_function)
+	{
+		m_batch_function(points, count, m_dimensions, stride, fitness);
+		return;
+	}
+
+	//Adapter for point function: buffer of thread is taken for whole block,
+	//nested evaluation on the same thread finds empty buffer and allocates own
+	static thread_local std::valarray<double> thread_point;
+	std::valarray<double> point(std::move(thread_point));
+	if (point.size() != m_dimensions)
+	{
+		point.resize(m_dimensions);
+	}
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const double* row = points + size_t(i) * stride;
+		std::copy(row, row + m_dimensions, std::begin(point));
+		fitness[i] = m_function(point);
+	}
+	thread_point = std::move(point);
+};
+
+//Buffers of cached evaluation, they are reused by calls on the same thread
+struct CachedBlock
+{
+	std::vector<std::uint64_t>	keys;
+	std::vector<unsigned int>	misses;
+	std::vector<int>			duplicates;
+	std::vector<double>			block;
+	std::vector<double>			block_fitness;
+};
+
+void ObjectiveFunction::EvaluateCached(const double* points, unsigned int count, unsigned int stride, double* fitness) const
+{
+	//Rows, which aren't in cache, are packed into one block; duplicates[i] is row of block with the same point
+	static thread_local CachedBlock thread_buffers;
+	CachedBlock buffers(std::move(thread_buffers));
+	std::vector<std::uint64_t>& keys = buffers.keys;
+	std::vector<unsigned int>& misses = buffers.misses;
+	std::vector<int>& duplicates = buffers.duplicates;
+	keys.resize(count);
+	misses.clear();
+	duplicates.assign(count, -1);
+	unsigned long long hits = 0;
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const double* row = points + size_t(i) * stride;
+		keys[i] = m_cache->GetKey(row, m_dimensions);
+		if (m_cache->Find(keys[i], row, m_dimensions, fitness[i]))
+		{
+			++hits;
+			continue;
+		}
+		for (unsigned int miss : misses)
+		{
+			if (keys[miss] == keys[i] && m_cache->IsSame(points + size_t(miss) * stride, row, m_dimensions))
+			{
+				duplicates[i] = static_cast<int>(miss);
+				++hits;
+				break;
+			}
+		}
+		if (duplicates[i] < 0)
+		{
+			misses.push_back(i);
+		}
+	}
+	m_cache->AddHits(hits);
+	m_cache->AddMisses(misses.size());
+	if (misses.empty())
+	{
+		thread_buffers = std::move(buffers);
+		return;
+	}
+
+	std::vector<double>& block = buffers.block;
+	std::vector<double>& block_fitness = buffers.block_fitness;
+	block.resize(misses.size() * m_dimensions);
+	block_fitness.resize(misses.size());
+	for (size_t i = 0; i < misses.size(); ++i)
+	{
+		const double* row = points + size_t(misses[i]) * stride;
+		std::copy(row, row + m_dimensions, block.begin() + i * m_dimensions);
+	}
+	EvaluateBlock(block.data(), static_cast<unsigned int>(misses.size()), m_dimensions, block_fitness.data());
+
+	for (size_t i = 0; i < misses.size(); ++i)
+	{
+		fitness[misses[i]] = block_fitness[i];
+		m_cache->Insert(keys[misses[i]], &block[i * m_dimensions], m_dimensions, block_fitness[i]);
+	}
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		if (duplicates[i] >= 0)
+		{
+			fitness[i] = fitness[duplicates[i]];
+		}
+	}
+	thread_buffers = std::move(buffers);
+};
+
+void ObjectiveFunction::ResetCache()
+{
+	if (m_cache)
+	{
+		m_cache = std::make_shared<EvaluationCache>(m_cache->GetTolerance(), m_cache->GetCapacity());
+	}
+};
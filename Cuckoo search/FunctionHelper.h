@@ -1,21 +1,45 @@
 /*
 	Description:
 		Objective function class contains function, number of function dimensions, its bounds and name. 
+		Function can be given for single point (PointFunction) or for block of points (BatchFunction).
+		Block is row-major matrix: point i starts at points + i * stride.
+		Search evaluates points by blocks, so PointFunction is called for each row of block
+		and single point is evaluated as block with one row.
+		Optional evaluation cache (EnableCache) is shared by copies of function: only
+		points, which aren't in cache, are passed to function, equal points of one block
+		are evaluated once.
+		Evaluation keeps its buffers in thread-local storage, so it doesn't allocate memory
+		(besides entries, which are added into cache).
+		Optional incremental function (SetIncrementalFunction) gets new point, previous
+		point with its fitness and coordinates, where points differ, so separable function
+		is updated in O(changed coordinates). It's used for subspace flights and doesn't use cache;
+		fitness, which is updated many times, accumulates rounding errors.
 */
 
 #ifndef FUNCTION_HELPER
 #define FUNCTION_HELPER
 
+#include "EvaluationCache.h"
+
 #include <functional>
 #include <valarray>
 #include <vector>
-#include <exception>
+#include <stdexcept>
 #include <string>
+#include <algorithm>
+#include <memory>
 
 using StopCritearian = std::function<bool()>;
 
 using StatisticsHandler = std::function<void()>;
 
+using PointFunction = std::function<double(const std::valarray<double>&)>;
+
+using BatchFunction = std::function<void(const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness)>;
+
+using IncrementalFunction = std::function<double(const double* point, const double* previous_point, double previous_fitness,
+	const unsigned int* changed, unsigned int count)>;
+
 struct Bounds
 {
 	double lower_bound;
@@ -25,28 +49,58 @@ struct Bounds
 class ObjectiveFunction
 {
 public:
-	ObjectiveFunction() { };
-	ObjectiveFunction(std::function<double(std::valarray<double>)> function, unsigned int dimensions, Bounds bounds, std::string function_name = "NaN");
-	ObjectiveFunction(std::function<double(std::valarray<double>)> function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name = "NaN");
+	ObjectiveFunction() :
+		m_dimensions(0) { };
+	ObjectiveFunction(PointFunction function, unsigned int dimensions, Bounds bounds, std::string function_name = "NaN");
+	ObjectiveFunction(PointFunction function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name = "NaN");
+	ObjectiveFunction(BatchFunction function, unsigned int dimensions, Bounds bounds, std::string function_name = "NaN");
+	ObjectiveFunction(BatchFunction function, unsigned int dimensions, std::vector<Bounds> bounds, std::string function_name = "NaN");
 
 	double operator()(const std::valarray<double>& args) const;
+	//Evaluates point with GetNumberOfDimensions() coordinates
+	double operator()(const double* args) const;
+	//Evaluates count points, which are rows of matrix with stride
+	void Evaluate(const double* points, unsigned int count, unsigned int stride, double* fitness) const;
+	//Evaluates point, which differs from previous point only in count changed coordinates
+	double EvaluateChange(const double* point, const double* previous_point, double previous_fitness,
+		const unsigned int* changed, unsigned int count) const;
 
 	void SetDimensions(unsigned int new_dimension);
 	inline void SetName(std::string new_name) { m_function_name = new_name; }
-	inline void ChangeFunction(std::function<double(std::valarray<double>)> new_function) { m_function = new_function; };
+	inline void ChangeFunction(PointFunction new_function) { m_function = new_function; m_batch_function = nullptr; m_incremental_function = nullptr; ResetCache(); };
+	inline void ChangeFunction(BatchFunction new_function) { m_batch_function = new_function; m_function = nullptr; m_incremental_function = nullptr; ResetCache(); };
+	//Batch function is used for blocks, point function is still used for single points
+	inline void SetBatchFunction(BatchFunction batch_function) { m_batch_function = batch_function; };
+	inline void SetIncrementalFunction(IncrementalFunction incremental_function) { m_incremental_function = incremental_function; };
+	//tolerance = 0 - only equal points are taken from cache
+	void EnableCache(double tolerance = 0.0, size_t capacity = EvaluationCache::DEFAULT_CAPACITY);
+	inline void DisableCache() { m_cache.reset(); };
 	inline void SetBounds(Bounds bounds) { m_bounds = std::vector<Bounds>(m_dimensions, bounds); };
 	inline void SetBounds(std::vector<Bounds> bounds){ m_bounds = bounds; };
 
 	inline unsigned int GetNumberOfDimensions() const { return m_dimensions; };
-	inline std::function<double(std::valarray<double>)> GetFunction() const { return m_function; };
+	inline PointFunction GetFunction() const { return m_function; };
+	inline BatchFunction GetBatchFunction() const { return m_batch_function; };
+	inline IncrementalFunction GetIncrementalFunction() const { return m_incremental_function; };
+	inline bool HasIncrementalFunction() const { return static_cast<bool>(m_incremental_function); };
 	inline std::vector<Bounds> GetBounds() const { return m_bounds; };
 	inline std::string GetName() const { return m_function_name; };
+	inline std::shared_ptr<EvaluationCache> GetCache() const { return m_cache; };
 
 private:
-	std::function<double(std::valarray<double>)>	m_function;
-	unsigned int									m_dimensions;
-	std::vector<Bounds>								m_bounds;
-	std::string										m_function_name;
+	PointFunction		m_function;
+	BatchFunction		m_batch_function;
+	IncrementalFunction	m_incremental_function;
+	unsigned int		m_dimensions;
+	std::vector<Bounds>	m_bounds;
+	std::string			m_function_name;
+	std::shared_ptr<EvaluationCache>	m_cache;
+
+	void CheckDimensions(size_t size) const;
+	void EvaluateBlock(const double* points, unsigned int count, unsigned int stride, double* fitness) const;
+	void EvaluateCached(const double* points, unsigned int count, unsigned int stride, double* fitness) const;
+	//Cached values belong to old function, copies of function with old function keep old cache
+	void ResetCache();
 };
 
 #endif // !FUNCTION_HELPER
@@ -0,0 +1,165 @@
+#include "IslandSearch.h"
+
+IslandSearch::IslandSearch(const CuckooSearch& cuckoo_search, unsigned int islands, unsigned int migration_interval,
+	unsigned int migration_size, MigrationTopology topology) :
+	m_islands(std::max(1u, islands), cuckoo_search), m_migration_interval(std::max(1u, migration_interval)),
+	m_migration_size(migration_size), m_topology(topology),
+	m_seed(cuckoo_search.GetSeed()), m_use_fixed_seed(cuckoo_search.IsFixedSeed()),
+	m_checkpoint_path(cuckoo_search.GetCheckpointPath()), m_checkpoint_interval(cuckoo_search.GetCheckpointInterval())
+{
+	m_executor = Executor::Create(static_cast<unsigned int>(m_islands.size()));
+};
+
+void IslandSearch::SetTransport(std::shared_ptr<MigrationTransport> transport)
+{
+	m_transport = transport;
+	if (m_transport)
+	{
+		m_islands.resize(1, m_islands[0]);
+		m_executor = Executor::Create(1);
+	}
+	else
+	{
+		m_executor = Executor::Create(static_cast<unsigned int>(m_islands.size()));
+	}
+};
+
+std::valarray<double> IslandSearch::FindMin()
+{
+	return GetSolution(true);
+};
+
+std::valarray<double> IslandSearch::FindMax()
+{
+	return GetSolution(false);
+};
+
+std::valarray<double> IslandSearch::GetSolution(bool minimize)
+{
+	SeedIslands();
+	SetIslandCheckpoints();
+	m_executor->ParallelFor(0, GetNumberOfIslands(), [&](unsigned int i)
+	{
+		if (minimize)
+		{
+			m_islands[i].StartMin();
+		}
+		else
+		{
+			m_islands[i].StartMax();
+		}
+	});
+	m_cmp_fitness = m_islands[0].GetCompareFitness();
+
+	//Islands have the same generations limit, so they finish together
+	bool running = true;
+	while (running)
+	{
+		std::vector<char> island_running(GetNumberOfIslands(), 1);
+		m_executor->ParallelFor(0, GetNumberOfIslands(), [&](unsigned int i)
+		{
+			for (unsigned int generation = 0; generation < m_migration_interval && island_running[i]; ++generation)
+			{
+				island_running[i] = m_islands[i].NextGeneration();
+			}
+		});
+		running = std::find(island_running.begin(), island_running.end(), 1) != island_running.end();
+		if (m_transport)
+		{
+			//All processes have to make the same number of exchanges
+			std::vector<Nest> state(1, Nest(Egg(), running ? 1.0 : 0.0, 1.0));
+			for (const Nest& nest : m_transport->Exchange(state))
+			{
+				running = running && (nest.GetFitness() != 0.0);
+			}
+		}
+		if (running)
+		{
+			Migrate();
+		}
+	}
+
+	MergeBest();
+	return m_best_ever.GetSolutions();
+};
+
+void IslandSearch::SeedIslands()
+{
+	//Islands need different random streams, seeds are derived from seed of first island
+	const std::uint64_t rank = m_transport ? m_transport->GetRank() : 0;
+	if (m_use_fixed_seed)
+	{
+		RandomEngine seeds(m_seed, rank);
+		for (CuckooSearch& island : m_islands)
+		{
+			island.SetSeed(seeds());
+		}
+	}
+};
+
+void IslandSearch::SetIslandCheckpoints()
+{
+	//Copies of search share writer of one file, so islands would overwrite checkpoints of each other
+	if (m_checkpoint_interval == 0)
+		return;
+	const unsigned int first_island = m_transport ? m_transport->GetRank() : 0;
+	for (unsigned int i = 0; i < GetNumberOfIslands(); ++i)
+	{
+		m_islands[i].SetCheckpointing(m_checkpoint_path + ".island" + std::to_string(first_island + i), m_checkpoint_interval);
+	}
+};
+
+void IslandSearch::Migrate()
+{
+	if (m_migration_size == 0)
+		return;
+
+	if (m_transport)
+	{
+		m_islands[0].ImportNests(m_transport->Exchange(m_islands[0].GetBestNests(m_migration_size)));
+		return;
+	}
+
+	const unsigned int islands = GetNumberOfIslands();
+	std::vector<SetOfNests> migrants(islands);
+	for (unsigned int i = 0; i < islands; ++i)
+	{
+		migrants[i] = m_islands[i].GetBestNests(m_migration_size);
+	}
+	m_executor->ParallelFor(0, islands, [&](unsigned int i)
+	{
+		SetOfNests arrived;
+		for (unsigned int source : GetMigrationSources(m_topology, i, islands))
+		{
+			arrived.insert(arrived.end(), migrants[source].begin(), migrants[source].end());
+		}
+		m_islands[i].ImportNests(arrived);
+	});
+};
+
+void IslandSearch::MergeBest()
+{
+	m_best_ever = m_islands[0].GetCurrentBestNest();
+	for (const CuckooSearch& island : m_islands)
+	{
+		if (m_cmp_fitness(island.GetCurrentBestValue(), m_best_ever.GetFitness()))
+		{
+			m_best_ever = island.GetCurrentBestNest();
+		}
+	}
+
+	if (m_transport)
+	{
+		//Ring reduction: after (size - 1) exchanges each process has global best
+		for (unsigned int step = 1; step < m_transport->GetSize(); ++step)
+		{
+			for (const Nest& nest : m_transport->Exchange(std::vector<Nest>(1, m_best_ever)))
+			{
+				if (m_cmp_fitness(nest.GetFitness(), m_best_ever.GetFitness()))
+				{
+					m_best_ever = nest;
+				}
+			}
+		}
+	}
+};
@@ -0,0 +1,71 @@
+/*
+	Description:
+		Island model of cuckoo search. K independent populations (islands) are
+		searched by copies of one CuckooSearch. Every migration interval the best nests
+		of each island migrate to other islands (ring or all to all topology) and
+		replace the worst nests there, if they are better.
+		Islands of one process are searched in parallel, each island uses one thread.
+		With transport each process is one island: migrants are exchanged with other
+		processes and at the end the best nest of all processes is merged (ring reduction),
+		so each process returns global best.
+		Checkpointing of given search is kept: island i writes checkpoints to file
+		"<path>.island<i>" (i is rank of process with transport).
+*/
+
+#ifndef ISLAND_SEARCH
+#define ISLAND_SEARCH
+
+#include "CuckooSearch.h"
+#include "MigrationTransport.h"
+#include "Executor.h"
+
+#include <vector>
+#include <memory>
+#include <string>
+
+class IslandSearch
+{
+public:
+	IslandSearch(const CuckooSearch& cuckoo_search, unsigned int islands = 4, unsigned int migration_interval = 50,
+		unsigned int migration_size = 2, MigrationTopology topology = MigrationTopology::RING);
+
+	std::valarray<double> FindMin();
+	std::valarray<double> FindMax();
+
+	inline Nest GetCurrentBestNest() const { return m_best_ever; };
+	inline double GetCurrentBestValue() const { return m_best_ever.GetFitness(); };
+	inline unsigned int GetNumberOfIslands() const { return static_cast<unsigned int>(m_islands.size()); };
+	inline const CuckooSearch& GetIsland(unsigned int island) const { return m_islands[island]; };
+	inline unsigned int GetMigrationInterval() const { return m_migration_interval; };
+	inline unsigned int GetMigrationSize() const { return m_migration_size; };
+	inline MigrationTopology GetTopology() const { return m_topology; };
+
+	inline void SetMigrationInterval(unsigned int generations) { m_migration_interval = std::max(1u, generations); };
+	inline void SetMigrationSize(unsigned int nests) { m_migration_size = nests; };
+	inline void SetTopology(MigrationTopology topology) { m_topology = topology; };
+	//Process mode: this process searches one island, other islands are in other processes
+	void SetTransport(std::shared_ptr<MigrationTransport> transport);
+
+protected:
+	std::vector<CuckooSearch>			m_islands;
+	std::shared_ptr<Executor>			m_executor;
+	std::shared_ptr<MigrationTransport>	m_transport;
+	unsigned int						m_migration_interval;
+	unsigned int						m_migration_size;
+	MigrationTopology					m_topology;
+	Nest								m_best_ever;
+	CompareFitness						m_cmp_fitness;
+	std::uint64_t						m_seed;
+	bool								m_use_fixed_seed;
+	std::string							m_checkpoint_path;
+	unsigned int						m_checkpoint_interval;
+
+	std::valarray<double> GetSolution(bool minimize);
+	void SeedIslands();
+	//Each island writes own checkpoint file: path.island<index>
+	void SetIslandCheckpoints();
+	void Migrate();
+	void MergeBest();
+};
+
+#endif // !ISLAND_SEARCH
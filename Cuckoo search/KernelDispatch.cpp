@@ -0,0 +1,170 @@
+#include "KernelDispatch.h"
+#include "Kernels.h"
+
+#include <cstdlib>
+#include <cstring>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#include <immintrin.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#define CUCKOO_X86
+#endif
+
+//Instruction set of kernels, which are compiled with flags of the whole program
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+static const InstructionSet BASELINE = InstructionSet::SSE2;
+#else
+static const InstructionSet BASELINE = InstructionSet::GENERIC;
+#endif
+
+#ifdef CUCKOO_KERNELS_AVX2
+const KernelTable& GetAvx2Kernels();
+#endif
+#ifdef CUCKOO_KERNELS_AVX512
+const KernelTable& GetAvx512Kernels();
+#endif
+
+static const KernelTable& GetBaselineKernels()
+{
+	static const KernelTable kernels = MakeKernelTable();
+	return kernels;
+};
+
+//Kernels, which are built for instruction set (nullptr - not built)
+static const KernelTable* FindKernels(InstructionSet instruction_set)
+{
+	if (instruction_set == BASELINE)
+		return &GetBaselineKernels();
+	switch (instruction_set)
+	{
+#ifdef CUCKOO_KERNELS_AVX2
+	case InstructionSet::AVX2:
+		return &GetAvx2Kernels();
+#endif
+#ifdef CUCKOO_KERNELS_AVX512
+	case InstructionSet::AVX512:
+		return &GetAvx512Kernels();
+#endif
+	default:
+		return nullptr;
+	}
+};
+
+static bool IsSupportedByProcessor(InstructionSet instruction_set)
+{
+	if (instruction_set == BASELINE)
+		return true;
+#if defined(CUCKOO_X86) && (defined(__GNUC__) || defined(__clang__))
+	//Checks of libgcc take into account support of registers by operating system
+	__builtin_cpu_init();
+	switch (instruction_set)
+	{
+	case InstructionSet::AVX2:
+		return __builtin_cpu_supports("avx2") != 0;
+	case InstructionSet::AVX512:
+		return __builtin_cpu_supports("avx512f") != 0;
+	default:
+		return false;
+	}
+#elif defined(CUCKOO_X86) && defined(_MSC_VER)
+	int registers[4];
+	__cpuid(registers, 0);
+	if (registers[0] < 7)
+		return false;
+	__cpuid(registers, 1);
+	const bool has_xsave = (registers[2] & (1 << 27)) != 0;
+	const bool has_avx = (registers[2] & (1 << 28)) != 0;
+	if (!has_xsave || !has_avx)
+		return false;
+	//Operating system saves YMM (bits 1, 2) and ZMM (bits 5, 6, 7) registers
+	const unsigned long long enabled_registers = _xgetbv(0);
+	__cpuidex(registers, 7, 0);
+	switch (instruction_set)
+	{
+	case InstructionSet::AVX2:
+		return (enabled_registers & 0x6) == 0x6 && (registers[1] & (1 << 5)) != 0;
+	case InstructionSet::AVX512:
+		return (enabled_registers & 0xE6) == 0xE6 && (registers[1] & (1 << 16)) != 0;
+	default:
+		return false;
+	}
+#else
+	return false;
+#endif
+};
+
+struct ActiveKernels
+{
+	InstructionSet		instruction_set;
+	const KernelTable*	kernels;
+};
+
+//The best available instruction set, which isn't better than CUCKOO_ISA
+static ActiveKernels ChooseKernels()
+{
+	unsigned int limit = static_cast<unsigned int>(InstructionSet::COUNT) - 1;
+	const char* name = std::getenv("CUCKOO_ISA");
+	for (unsigned int i = 0; name && i < static_cast<unsigned int>(InstructionSet::COUNT); ++i)
+	{
+		if (std::strcmp(name, KernelDispatch::GetName(static_cast<InstructionSet>(i))) == 0)
+		{
+			limit = i;
+		}
+	}
+	for (unsigned int i = limit + 1; i-- > 0;)
+	{
+		const InstructionSet instruction_set = static_cast<InstructionSet>(i);
+		if (KernelDispatch::IsAvailable(instruction_set))
+			return { instruction_set, FindKernels(instruction_set) };
+	}
+	return { BASELINE, FindKernels(BASELINE) };
+};
+
+static ActiveKernels& GetActiveKernels()
+{
+	static ActiveKernels active = ChooseKernels();
+	return active;
+};
+
+const KernelTable& KernelDispatch::GetKernels()
+{
+	return *GetActiveKernels().kernels;
+};
+
+InstructionSet KernelDispatch::GetInstructionSet()
+{
+	return GetActiveKernels().instruction_set;
+};
+
+bool KernelDispatch::SetInstructionSet(InstructionSet instruction_set)
+{
+	if (!IsAvailable(instruction_set))
+		return false;
+	GetActiveKernels() = { instruction_set, FindKernels(instruction_set) };
+	return true;
+};
+
+bool KernelDispatch::IsAvailable(InstructionSet instruction_set)
+{
+	return FindKernels(instruction_set) != nullptr && IsSupportedByProcessor(instruction_set);
+};
+
+const char* KernelDispatch::GetName(InstructionSet instruction_set)
+{
+	switch (instruction_set)
+	{
+	case InstructionSet::GENERIC:
+		return "generic";
+	case InstructionSet::SSE2:
+		return "sse2";
+	case InstructionSet::AVX2:
+		return "avx2";
+	case InstructionSet::AVX512:
+		return "avx512";
+	default:
+		return "unknown";
+	}
+};
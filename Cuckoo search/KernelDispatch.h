@@ -0,0 +1,68 @@
+/*
+	Description:
+		Runtime dispatch of hot kernels (Kernels.h) by instruction set of processor.
+		Kernels are compiled once with flags of the whole program (baseline: SSE2 on x86)
+		and, when build defines CUCKOO_KERNELS_AVX2 / CUCKOO_KERNELS_AVX512, once more in
+		KernelsAvx2.cpp / KernelsAvx512.cpp with flags of that instruction set.
+		At startup the best instruction set, which is built and supported by processor
+		(and operating system), is chosen. Environment variable CUCKOO_ISA
+		(generic, sse2, avx2, avx512) limits the choice, e.g. to compare instruction sets.
+		Contraction of floating point operations (FMA) is disabled for all variants,
+		so variants give equal results and seeded search is reproducible on any processor.
+*/
+
+#ifndef KERNEL_DISPATCH
+#define KERNEL_DISPATCH
+
+enum class InstructionSet : unsigned int
+{
+	GENERIC,
+	SSE2,
+	AVX2,
+	AVX512,
+	COUNT
+};
+
+enum class KernelId : unsigned int
+{
+	SPHERE,
+	ACKLEY,
+	GRIEWANK,
+	RASTRIGIN,
+	ROSENBROCK,
+	MICHAELWICZ,
+	COUNT
+};
+
+const unsigned int OBJECTIVE_KERNELS = static_cast<unsigned int>(KernelId::COUNT);
+
+//Evaluates count points, which are rows of matrix with stride
+using ObjectiveKernelFunction = void(*)(const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness);
+//Transforms uniform variables (radius in (0, 1], angle in [0, 1)) into count Levy steps
+using LevyStepsFunction = void(*)(const double* radius, const double* angle, unsigned int count,
+	double sigma_x, double inverse_lambda, double* steps);
+
+struct KernelTable
+{
+	ObjectiveKernelFunction	objective[OBJECTIVE_KERNELS];
+	LevyStepsFunction		levy_steps;
+};
+
+class KernelDispatch
+{
+public:
+	//Kernels of active instruction set
+	static const KernelTable& GetKernels();
+	static InstructionSet GetInstructionSet();
+	//Kernels can be switched only between runs of search.
+	//Returns false, if kernels of instruction set aren't available
+	static bool SetInstructionSet(InstructionSet instruction_set);
+	//Kernels are built and processor supports instruction set
+	static bool IsAvailable(InstructionSet instruction_set);
+	static const char* GetName(InstructionSet instruction_set);
+
+private:
+	KernelDispatch() = delete;
+};
+
+#endif // !KERNEL_DISPATCH
@@ -0,0 +1,380 @@
+/*
+	Description:
+		Hot kernels of search: kernels of benchmark functions for raw points (pointer
+		to coordinates) and transform of uniform variables into Levy steps.
+		Each objective kernel is template by number of dimensions: Kernel<D> has loops with
+		fixed length, which are unrolled and vectorized by compiler, Kernel<0> works with
+		any number of dimensions. Terms of coordinates are computed by blocks in plain loops
+		(cos of terms is KernelCos, libm calls aren't vectorized), sums and products are
+		accumulated in 4 independent lanes, so loops don't depend on order of additions
+		and all instruction sets give equal results.
+		EvaluateKernel chooses specialization by number of dimensions and evaluates
+		block of points.
+		Header is compiled for several instruction sets (see KernelDispatch.h): translation
+		unit of instruction set defines CUCKOO_KERNEL_NAMESPACE, so its kernels don't mix
+		with kernels of other units. Therefore kernels don't call templates and inline functions
+		of standard library: their code would be shared by all units.
+*/
+
+#ifndef KERNELS
+#define KERNELS
+
+#include "KernelDispatch.h"
+#include "Simd.h"
+
+#define _USE_MATH_DEFINES
+#include <math.h>
+#include <cmath>
+#include <cfloat>
+#include <cstdint>
+#include <cstring>
+
+#ifdef CUCKOO_KERNEL_NAMESPACE
+namespace CUCKOO_KERNEL_NAMESPACE {
+#endif
+
+const unsigned int KERNEL_LANES = 4;
+//Terms are computed by blocks in plain loop, which is vectorized even with
+//divisions and conversions (loop of lanes with them isn't)
+const unsigned int KERNEL_BLOCK = 16 * KERNEL_LANES;
+
+//combine(term(x[0], 0), ..., term(x[n - 1], n - 1)): term i goes to lane i % KERNEL_LANES,
+//terms after the last full group of lanes go to lane 0
+template <unsigned int Dimensions, typename Term, typename Combine>
+inline double KernelReduce(const double* x, unsigned int dimensions, Term term, double initial, Combine combine)
+{
+	const unsigned int size = Dimensions ? Dimensions : dimensions;
+	double lanes[KERNEL_LANES] = { initial, initial, initial, initial };
+	double terms[KERNEL_BLOCK];
+	for (unsigned int block = 0; block < size; block += KERNEL_BLOCK)
+	{
+		const unsigned int block_size = (size - block < KERNEL_BLOCK) ? size - block : KERNEL_BLOCK;
+		CUCKOO_SIMD_LOOP
+		for (unsigned int i = 0; i < block_size; ++i)
+		{
+			terms[i] = term(x[block + i], block + i);
+		}
+		const unsigned int full_size = block_size - block_size % KERNEL_LANES;
+		for (unsigned int i = 0; i < full_size; i += KERNEL_LANES)
+		{
+			CUCKOO_SIMD_LOOP
+			for (unsigned int lane = 0; lane < KERNEL_LANES; ++lane)
+			{
+				lanes[lane] = combine(lanes[lane], terms[i + lane]);
+			}
+		}
+		for (unsigned int i = full_size; i < block_size; ++i)
+		{
+			lanes[0] = combine(lanes[0], terms[i]);
+		}
+	}
+	return combine(combine(lanes[0], lanes[1]), combine(lanes[2], lanes[3]));
+};
+
+//Sum of term(x[i], i) for all coordinates
+template <unsigned int Dimensions, typename Term>
+inline double KernelSum(const double* x, unsigned int dimensions, Term term)
+{
+	return KernelReduce<Dimensions>(x, dimensions, term, 0.0, [](double sum, double value) { return sum + value; });
+};
+
+/*	Elementary functions for loops of kernels: calls of libm stop vectorization, so
+	they are computed by range reduction and polynomials (Taylor series, error is
+	a few ulp) only with +, -, *, /, sqrt and operations on bits. These operations
+	are exact or correctly rounded in any instruction set, so vectorized and scalar
+	loops give equal results.	*/
+
+//1.5 * 2^52: x + KERNEL_SHIFTER - KERNEL_SHIFTER rounds |x| < 2^51 to integer,
+//low bits of x + KERNEL_SHIFTER are this integer
+const double KERNEL_SHIFTER = 6755399441055744.0;
+const std::uint64_t KERNEL_EXPONENT_BIAS = 0x3ff0000000000000ULL;
+
+inline std::uint64_t KernelBits(double value)
+{
+	std::uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+};
+
+inline double KernelDouble(std::uint64_t bits)
+{
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+};
+
+//condition ? if_true : if_false by masks of bits: compiler doesn't turn branches with
+//floating point operations (they can trap) into vector blends
+inline double KernelSelect(bool condition, double if_true, double if_false)
+{
+	const std::uint64_t mask = std::uint64_t(0) - std::uint64_t(condition);
+	return KernelDouble((KernelBits(if_true) & mask) | (KernelBits(if_false) & ~mask));
+};
+
+//Natural logarithm of positive normal number
+inline double KernelLog(double x)
+{
+	//x = 2^k * z, z in [sqrt(2) / 2, sqrt(2)), offset keeps shifted exponent nonnegative
+	const std::uint64_t bits = KernelBits(x);
+	const std::uint64_t biased_k = (bits - 0x3fe6a09e667f3bcdULL + KERNEL_EXPONENT_BIAS) >> 52;
+	const double z = KernelDouble(bits - (biased_k << 52) + KERNEL_EXPONENT_BIAS);
+	const double k = (KernelDouble(KernelBits(KERNEL_SHIFTER) + biased_k) - KERNEL_SHIFTER) - 1023.0;
+
+	//log(z) = 2 * atanh(s), s = (z - 1) / (z + 1), |s| < 0.172
+	const double f = z - 1.0;
+	const double s = f / (2.0 + f);
+	const double s2 = s * s;
+	double series = 1.0 / 23.0;
+	series = series * s2 + 1.0 / 21.0;
+	series = series * s2 + 1.0 / 19.0;
+	series = series * s2 + 1.0 / 17.0;
+	series = series * s2 + 1.0 / 15.0;
+	series = series * s2 + 1.0 / 13.0;
+	series = series * s2 + 1.0 / 11.0;
+	series = series * s2 + 1.0 / 9.0;
+	series = series * s2 + 1.0 / 7.0;
+	series = series * s2 + 1.0 / 5.0;
+	series = series * s2 + 1.0 / 3.0;
+	const double log_z = 2.0 * s + 2.0 * s * (s2 * series);
+	//ln(2) = hi + lo, k * hi is exact
+	return k * 6.93147180369123816490e-01 + (k * 1.90821492927058770002e-10 + log_z);
+};
+
+//Exponent, results less than DBL_MIN are 0
+inline double KernelExp(double x)
+{
+	const double clamped = KernelSelect(x < -708.39, -708.39, KernelSelect(x > 709.78, 709.78, x));
+	//x = n * ln(2) + r, |r| <= ln(2) / 2
+	const double shifted = clamped * 1.44269504088896338700e+00 + KERNEL_SHIFTER;
+	const double n = shifted - KERNEL_SHIFTER;
+	const double r = (clamped - n * 6.93147180369123816490e-01) - n * 1.90821492927058770002e-10;
+
+	double series = 1.0 / 6227020800.0;
+	series = series * r + 1.0 / 479001600.0;
+	series = series * r + 1.0 / 39916800.0;
+	series = series * r + 1.0 / 3628800.0;
+	series = series * r + 1.0 / 362880.0;
+	series = series * r + 1.0 / 40320.0;
+	series = series * r + 1.0 / 5040.0;
+	series = series * r + 1.0 / 720.0;
+	series = series * r + 1.0 / 120.0;
+	series = series * r + 1.0 / 24.0;
+	series = series * r + 1.0 / 6.0;
+	series = series * r + 0.5;
+	const double exp_r = 1.0 + (r + r * (r * series));
+	//2^n from bits of integer n, 2^1024 isn't finite, so it's 2^1023 * 2
+	const bool is_max_n = n > 1023.0;
+	const double scale = KernelDouble((KernelBits(KernelSelect(is_max_n, 1023.0, n) + KERNEL_SHIFTER) + 1023) << 52);
+	const double result = exp_r * scale * KernelSelect(is_max_n, 2.0, 1.0);
+	return KernelSelect(x > 709.78, HUGE_VAL, KernelSelect(x < -708.39, 0.0, result));
+};
+
+//Cosine of |x| < 2^20 * pi / 2
+inline double KernelCos(double x)
+{
+	//x = n * pi / 2 + r, |r| <= pi / 4, pi / 2 = p1 + p2 + p3, n * p1 and n * p2 are exact
+	const double shifted = x * 6.36619772367581382433e-01 + KERNEL_SHIFTER;
+	const double n = shifted - KERNEL_SHIFTER;
+	const std::uint64_t quadrant = KernelBits(shifted) & 3;
+	const double r = ((x - n * 1.57079632673412561417e+00) - n * 6.07710050630396597660e-11) - n * 2.02226624879595063154e-21;
+	const double r2 = r * r;
+
+	double sin_series = -1.0 / 355687428096000.0;
+	sin_series = sin_series * r2 + 1.0 / 1307674368000.0;
+	sin_series = sin_series * r2 - 1.0 / 6227020800.0;
+	sin_series = sin_series * r2 + 1.0 / 39916800.0;
+	sin_series = sin_series * r2 - 1.0 / 362880.0;
+	sin_series = sin_series * r2 + 1.0 / 5040.0;
+	sin_series = sin_series * r2 - 1.0 / 120.0;
+	sin_series = sin_series * r2 + 1.0 / 6.0;
+	const double sin_r = r - r * (r2 * sin_series);
+
+	double cos_series = 1.0 / 20922789888000.0;
+	cos_series = cos_series * r2 - 1.0 / 87178291200.0;
+	cos_series = cos_series * r2 + 1.0 / 479001600.0;
+	cos_series = cos_series * r2 - 1.0 / 3628800.0;
+	cos_series = cos_series * r2 + 1.0 / 40320.0;
+	cos_series = cos_series * r2 - 1.0 / 720.0;
+	cos_series = cos_series * r2 + 1.0 / 24.0;
+	const double cos_r = (1.0 - 0.5 * r2) + r2 * (r2 * cos_series);
+
+	//cos(x) by quadrant: cos(r), -sin(r), -cos(r), sin(r)
+	const double value = KernelSelect((quadrant & 1) != 0, sin_r, cos_r);
+	return KernelDouble(KernelBits(value) ^ (((quadrant + 1) & 2) << 62));
+};
+
+template <unsigned int Dimensions>
+struct SphereKernel
+{
+	static const KernelId ID = KernelId::SPHERE;
+
+	static inline double Term(double value)
+	{
+		return value * value;
+	};
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		return KernelSum<Dimensions>(x, dimensions, [](double value, unsigned int) { return Term(value); });
+	};
+};
+
+template <unsigned int Dimensions>
+struct AckleyKernel
+{
+	static const KernelId ID = KernelId::ACKLEY;
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		const double a = 20.0;
+		const double b = 0.2;
+		const double c = M_PI * 2.0;
+		const double size = double(Dimensions ? Dimensions : dimensions);
+		const double cubic_sum = KernelSum<Dimensions>(x, dimensions, [](double value, unsigned int) { return value * value; });
+		const double cos_sum = KernelSum<Dimensions>(x, dimensions, [&](double value, unsigned int) { return KernelCos(c * value); });
+		const double first_arg = a * std::exp(-b * std::sqrt((1.0 / size) * cubic_sum));
+		const double second_arg = std::exp((1.0 / size) * cos_sum);
+		return (M_E - second_arg) + a - first_arg;
+	};
+};
+
+template <unsigned int Dimensions>
+struct GriewankKernel
+{
+	static const KernelId ID = KernelId::GRIEWANK;
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		const double sum = KernelSum<Dimensions>(x, dimensions, [](double value, unsigned int) { return value * value; }) / 4000.0;
+		const double product = KernelReduce<Dimensions>(x, dimensions, [](double value, unsigned int i) { return KernelCos(value / double(i + 1)); },
+			1.0, [](double product, double value) { return product * value; });
+		return sum - product + 1.0;
+	};
+};
+
+template <unsigned int Dimensions>
+struct RastriginKernel
+{
+	static const KernelId ID = KernelId::RASTRIGIN;
+
+	static inline double Term(double value)
+	{
+		return value * value - 10.0 * KernelCos(2.0 * M_PI * value);
+	};
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		const unsigned int size = Dimensions ? Dimensions : dimensions;
+		return 10.0 * size + KernelSum<Dimensions>(x, dimensions, [](double value, unsigned int) { return Term(value); });
+	};
+};
+
+template <unsigned int Dimensions>
+struct RosenbrockKernel
+{
+	static const KernelId ID = KernelId::ROSENBROCK;
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		const unsigned int size = Dimensions ? Dimensions : dimensions;
+		if (size < 2)
+			return 0.0;
+		//Term i uses x[i] and x[i + 1], so sum goes over first (size - 1) coordinates
+		return KernelSum<(Dimensions > 1) ? Dimensions - 1 : 0>(x, size - 1, [&](double value, unsigned int i)
+		{
+			const double difference = x[i + 1] - value * value;
+			return 100.0 * difference * difference + (value - 1.0) * (value - 1.0);
+		});
+	};
+};
+
+template <unsigned int Dimensions>
+struct MichaelwiczKernel
+{
+	static const KernelId ID = KernelId::MICHAELWICZ;
+
+	static inline double Evaluate(const double* x, unsigned int dimensions)
+	{
+		const unsigned int size = Dimensions ? Dimensions : dimensions;
+		const double m = 10;
+		const double first = x[0];
+		const double last = x[size - 1];
+		const double first_arg = -std::sin(first) * std::pow(std::sin(first * first / M_PI), 2.0 * m);
+		const double second_arg = -std::sin(last) * std::pow(std::sin(2.0 * last * last / M_PI), 2.0 * m);
+		return first_arg + second_arg;
+	};
+};
+
+template <template <unsigned int> class Kernel, unsigned int Dimensions>
+inline void EvaluateRows(const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness)
+{
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		fitness[i] = Kernel<Dimensions>::Evaluate(points + size_t(i) * stride, dimensions);
+	}
+};
+
+//Block of points, specializations for dimensions of test functions
+template <template <unsigned int> class Kernel>
+inline void EvaluateKernel(const double* points, unsigned int count, unsigned int dimensions, unsigned int stride, double* fitness)
+{
+	switch (dimensions)
+	{
+	case 2:
+		EvaluateRows<Kernel, 2>(points, count, dimensions, stride, fitness);
+		break;
+	case 20:
+		EvaluateRows<Kernel, 20>(points, count, dimensions, stride, fitness);
+		break;
+	case 30:
+		EvaluateRows<Kernel, 30>(points, count, dimensions, stride, fitness);
+		break;
+	case 50:
+		EvaluateRows<Kernel, 50>(points, count, dimensions, stride, fitness);
+		break;
+	case 100:
+		EvaluateRows<Kernel, 100>(points, count, dimensions, stride, fitness);
+		break;
+	default:
+		EvaluateRows<Kernel, 0>(points, count, dimensions, stride, fitness);
+		break;
+	}
+};
+
+//Mantegna algorithm: Box-Muller gives two independent normal values x ~ N(0, sigma_x), y ~ N(0, 1),
+//step is x / |y|^(1 / lambda). radius must be in (0, 1], so logarithm is finite.
+//sin(phi) is written as cos(phi - pi/2), functions of kernels keep loop vectorized
+inline void LevyStepsKernel(const double* radius, const double* angle, unsigned int count,
+	double sigma_x, double inverse_lambda, double* steps)
+{
+	CUCKOO_SIMD_LOOP
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		const double r = std::sqrt(-2.0 * KernelLog(radius[i]));
+		const double phi = 2.0 * M_PI * angle[i];
+		const double x = sigma_x * r * KernelCos(phi);
+		const double abs_y = std::fabs(r * KernelCos(phi - M_PI / 2.0));
+		const double y = KernelSelect(abs_y < DBL_MIN, DBL_MIN, abs_y);
+
+		steps[i] = x * KernelExp(-KernelLog(y) * inverse_lambda);
+	}
+};
+
+inline KernelTable MakeKernelTable()
+{
+	KernelTable table;
+	table.objective[static_cast<unsigned int>(KernelId::SPHERE)] = &EvaluateKernel<SphereKernel>;
+	table.objective[static_cast<unsigned int>(KernelId::ACKLEY)] = &EvaluateKernel<AckleyKernel>;
+	table.objective[static_cast<unsigned int>(KernelId::GRIEWANK)] = &EvaluateKernel<GriewankKernel>;
+	table.objective[static_cast<unsigned int>(KernelId::RASTRIGIN)] = &EvaluateKernel<RastriginKernel>;
+	table.objective[static_cast<unsigned int>(KernelId::ROSENBROCK)] = &EvaluateKernel<RosenbrockKernel>;
+	table.objective[static_cast<unsigned int>(KernelId::MICHAELWICZ)] = &EvaluateKernel<MichaelwiczKernel>;
+	table.levy_steps = &LevyStepsKernel;
+	return table;
+};
+
+#ifdef CUCKOO_KERNEL_NAMESPACE
+}
+#endif
+
+#endif // !KERNELS
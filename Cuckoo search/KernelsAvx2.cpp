@@ -0,0 +1,13 @@
+//Kernels compiled with AVX2 flags (see KernelDispatch.h)
+#ifdef CUCKOO_KERNELS_AVX2
+
+#define CUCKOO_KERNEL_NAMESPACE Avx2Kernels
+#include "Kernels.h"
+
+const KernelTable& GetAvx2Kernels()
+{
+	static const KernelTable kernels = Avx2Kernels::MakeKernelTable();
+	return kernels;
+};
+
+#endif // CUCKOO_KERNELS_AVX2
@@ -0,0 +1,13 @@
+//Kernels compiled with AVX512 flags (see KernelDispatch.h)
+#ifdef CUCKOO_KERNELS_AVX512
+
+#define CUCKOO_KERNEL_NAMESPACE Avx512Kernels
+#include "Kernels.h"
+
+const KernelTable& GetAvx512Kernels()
+{
+	static const KernelTable kernels = Avx512Kernels::MakeKernelTable();
+	return kernels;
+};
+
+#endif // CUCKOO_KERNELS_AVX512
@@ -1,63 +1,67 @@
 #include "LevyFlight.h"
+#include "KernelDispatch.h"
 
+#include <algorithm>
+#include <cstring>
 
-std::valarray<double> LevyFlight::GetValue(double lambda, unsigned int dimension)
+std::valarray<double> LevyFlight::GetValue(double lambda, RandomEngine& random_engine, unsigned int dimension)
 {
 	std::valarray<double> result(dimension);
-
-	const double divider = std::tgamma((lambda + 1.0) / 2.0) * lambda *
-		std::pow(2.0, (lambda - 1.0) / 2.0);
-	const double sigma_x = std::pow(((std::tgamma(1.0 + lambda) * std::sin((M_PI * lambda) / 2.0)) / divider), 1.0 / lambda);
-	const double sigma_y = 1.0;
-
-	Concurrency::parallel_for<unsigned long int>(0, dimension, [&](unsigned long int i)
-	{
-		const double x = GetNormalDistribution(0.0, sigma_x);
-		const double y = GetNormalDistribution(0.0, sigma_y);
-
-		result[i] = x / std::pow(std::abs(y), 1.0 / lambda);
-	});
-
+	FillSteps(&result[0], dimension, lambda, random_engine);
 	return result;
 };
 
-double LevyFlight::GetNormalDistribution(double mue, double sigma)
+void LevyFlight::FillSteps(double* steps, unsigned int count, double lambda, RandomEngine& random_engine)
 {
-	static std::map<double, StochasticBuffer> variables;
-	auto value = variables.find(sigma);
-	if (value != variables.end())
+	const unsigned int block_size = 64;
+	double radius[block_size];
+	double angle[block_size];
+
+	const double sigma_x = GetSigma(lambda);
+	const double inverse_lambda = 1.0 / lambda;
+	const KernelTable& kernels = KernelDispatch::GetKernels();
+
+	for (unsigned int offset = 0; offset < count; offset += block_size)
 	{
-		if (!value->second.use_second)
+		const unsigned int size = std::min(block_size, count - offset);
+		for (unsigned int i = 0; i < size; ++i)
 		{
-			auto stochastic_pair = BoxMullerTransform(mue, sigma);
-			value->second.second_number = mue + sigma * stochastic_pair.second;
-			value->second.use_second = true;
-
-			return mue + sigma * stochastic_pair.first;
+			//1 - U is in (0, 1], so logarithm is finite
+			radius[i] = 1.0 - random_engine.Uniform();
+			angle[i] = random_engine.Uniform();
 		}
-
-		value->second.use_second = false;
-		return value->second.second_number;
+		kernels.levy_steps(radius, angle, size, sigma_x, inverse_lambda, steps + offset);
 	}
-	auto stochastic_pair = BoxMullerTransform(mue, sigma);
-	variables.insert(std::pair<double, StochasticBuffer>(sigma, StochasticBuffer(stochastic_pair.second, true)));
+};
+
+double LevyFlight::GetSigma(double lambda)
+{
+	//Direct mapped cache, lambdas of nests take small set of values
+	struct CachedSigma
+	{
+		double lambda;
+		double sigma;
+		//Zero initialized entries are empty, lambda 0 isn't cached before first call
+		bool is_valid;
+	};
+	const unsigned int cache_size = 256;
+	static thread_local CachedSigma cache[cache_size] = {};
 
-	return stochastic_pair.first;
-	
+	std::uint64_t bits;
+	std::memcpy(&bits, &lambda, sizeof(bits));
+	CachedSigma& entry = cache[(bits ^ (bits >> 29) ^ (bits >> 41)) % cache_size];
+	if (!entry.is_valid || entry.lambda != lambda)
+	{
+		entry.lambda = lambda;
+		entry.sigma = CalculateSigma(lambda);
+		entry.is_valid = true;
+	}
+	return entry.sigma;
 };
 
-std::pair<double, double> LevyFlight::BoxMullerTransform(double mue, double sigma)
+double LevyFlight::CalculateSigma(double lambda)
 {
-	double x;
-	double y;
-	double s;
-	do {
-		x = 2.0 * rand() / (RAND_MAX + 1) - 1.0;
-		y = 2.0 * rand() / (RAND_MAX + 1) - 1.0;
-		s = x * x + y * y;
-	} while (s > 1.0);
-	const double z0 = x * std::sqrt((-2.0 * std::log(s) / s));
-	const double z1 = y * std::sqrt((-2.0 * std::log(s) / s));
-
-	return std::pair<double, double>(mue + sigma * z0, mue + sigma * z1);
-};
\ No newline at end of file
+	const double divider = std::tgamma((lambda + 1.0) / 2.0) * lambda *
+		std::pow(2.0, (lambda - 1.0) / 2.0);
+	return std::pow(((std::tgamma(1.0 + lambda) * std::sin((M_PI * lambda) / 2.0)) / divider), 1.0 / lambda);
+};
@@ -2,36 +2,33 @@
 	Description:
 		Function produce stochastic values, which distributed by Levy stable distribution.
 		For this purpose used Mantegna algorithm.
+		Normal variables are taken from random engine of caller, so function doesn't
+		have shared state and can be called from many threads.
+		Steps are generated by blocks: uniform variables are taken from engine first,
+		after that Box-Muller transform and Mantegna formula are applied to whole block
+		by vectorized kernel of active instruction set (see KernelDispatch.h).
+		Sigma depends only on lambda and is cached for each thread.
 */
 
 #ifndef LEVY_FLIGHT
 #define LEVY_FLIGHT
 
+#include "Random.h"
+
 #include <valarray>
-#include <map>
-#include <utility>
-#include <ppl.h>
 
 #define _USE_MATH_DEFINES
 #include <math.h>
-#include <random>
-#include <time.h>
-
-struct StochasticBuffer
-{
-	StochasticBuffer(double number, bool use) :
-		second_number(number), use_second(use) {};
-	double second_number;
-	bool use_second = false;
-};
 
 class LevyFlight
 {
 public:
-	static std::valarray<double> GetValue(double lambda, unsigned int dimension = 1);
+	static std::valarray<double> GetValue(double lambda, RandomEngine& random_engine, unsigned int dimension = 1);
+	//Fills count Levy steps
+	static void FillSteps(double* steps, unsigned int count, double lambda, RandomEngine& random_engine);
+	static double GetSigma(double lambda);
 protected:
-	static double GetNormalDistribution(double mue, double sigma);
-	static std::pair<double, double> BoxMullerTransform(double mue, double sigma);
+	static double CalculateSigma(double lambda);
 private:
 	LevyFlight() = delete;
 	LevyFlight(LevyFlight&) = delete;
@@ -39,4 +36,3 @@ private:
 };
 
 #endif // !LEVY_FLIGHT
-
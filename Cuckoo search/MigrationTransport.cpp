@@ -0,0 +1,355 @@
+#include "MigrationTransport.h"
+
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <poll.h>
+#include <unistd.h>
+#include <errno.h>
+#endif
+
+std::vector<unsigned int> GetMigrationTargets(MigrationTopology topology, unsigned int island, unsigned int islands)
+{
+	std::vector<unsigned int> targets;
+	if (islands < 2)
+		return targets;
+	if (topology == MigrationTopology::RING)
+	{
+		targets.push_back((island + 1) % islands);
+		return targets;
+	}
+	for (unsigned int i = 0; i < islands; ++i)
+	{
+		if (i != island)
+		{
+			targets.push_back(i);
+		}
+	}
+	return targets;
+};
+
+std::vector<unsigned int> GetMigrationSources(MigrationTopology topology, unsigned int island, unsigned int islands)
+{
+	std::vector<unsigned int> sources;
+	if (islands < 2)
+		return sources;
+	if (topology == MigrationTopology::RING)
+	{
+		sources.push_back((island + islands - 1) % islands);
+		return sources;
+	}
+	return GetMigrationTargets(topology, island, islands);
+};
+
+#ifndef _WIN32
+
+static void WriteAll(int socket, const void* data, size_t size)
+{
+	const char* bytes = static_cast<const char*>(data);
+	while (size > 0)
+	{
+		const ssize_t written = ::send(socket, bytes, size, MSG_NOSIGNAL);
+		if (written < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw std::runtime_error("Can't send migrants: " + std::string(std::strerror(errno)) + "\n");
+		}
+		bytes += written;
+		size -= static_cast<size_t>(written);
+	}
+};
+
+static void ReadAll(int socket, void* data, size_t size)
+{
+	char* bytes = static_cast<char*>(data);
+	while (size > 0)
+	{
+		const ssize_t received = ::recv(socket, bytes, size, 0);
+		if (received == 0)
+			throw std::runtime_error("Island closed connection\n");
+		if (received < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw std::runtime_error("Can't receive migrants: " + std::string(std::strerror(errno)) + "\n");
+		}
+		bytes += received;
+		size -= static_cast<size_t>(received);
+	}
+};
+
+LocalSocketTransport::LocalSocketTransport(const std::string& path_prefix, unsigned int rank, unsigned int size,
+	MigrationTopology topology, unsigned int connect_timeout_seconds) :
+	m_path_prefix(path_prefix), m_rank(rank), m_size(size), m_listen_socket(-1)
+{
+	if (rank >= size)
+		throw std::invalid_argument("Rank of island must be less than number of islands\n");
+
+	const std::vector<unsigned int> targets = GetMigrationTargets(topology, rank, size);
+	const std::vector<unsigned int> sources = GetMigrationSources(topology, rank, size);
+
+	//Listen first: connections of other islands wait in backlog until they are accepted
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	const std::string path = GetSocketPath(rank);
+	if (path.size() >= sizeof(address.sun_path))
+		throw std::invalid_argument("Socket path is too long\n");
+	std::strcpy(address.sun_path, path.c_str());
+	::unlink(path.c_str());
+
+	m_listen_socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+	if (m_listen_socket < 0 ||
+		::bind(m_listen_socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+		::listen(m_listen_socket, static_cast<int>(size)) < 0)
+	{
+		const std::string error = std::strerror(errno);
+		Close();
+		throw std::runtime_error("Can't listen on " + path + ": " + error + "\n");
+	}
+
+	try
+	{
+		for (unsigned int target : targets)
+		{
+			const int socket = ConnectTo(target, connect_timeout_seconds);
+			m_target_sockets.push_back(socket);
+			const std::uint32_t own_rank = m_rank;
+			WriteAll(socket, &own_rank, sizeof(own_rank));
+		}
+
+		//Sources are kept in order of GetMigrationSources
+		m_source_sockets.assign(sources.size(), -1);
+		for (size_t i = 0; i < sources.size(); ++i)
+		{
+			const int socket = ::accept(m_listen_socket, nullptr, nullptr);
+			if (socket < 0)
+				throw std::runtime_error("Can't accept island: " + std::string(std::strerror(errno)) + "\n");
+			std::uint32_t source_rank;
+			ReadAll(socket, &source_rank, sizeof(source_rank));
+			const auto position = std::find(sources.begin(), sources.end(), source_rank);
+			if (position == sources.end() || m_source_sockets[position - sources.begin()] >= 0)
+			{
+				::close(socket);
+				throw std::runtime_error("Unexpected island connected\n");
+			}
+			m_source_sockets[position - sources.begin()] = socket;
+		}
+	}
+	catch (...)
+	{
+		Close();
+		throw;
+	}
+};
+
+LocalSocketTransport::~LocalSocketTransport()
+{
+	Close();
+};
+
+std::vector<Nest> LocalSocketTransport::Exchange(const std::vector<Nest>& migrants)
+{
+	//Message: header (number of nests, dimensions) and nests
+	const std::uint32_t header[2] = { static_cast<std::uint32_t>(migrants.size()),
+		migrants.empty() ? 0u : static_cast<std::uint32_t>(migrants[0].GetSolutionsRef().size()) };
+	std::vector<double> values;
+	for (const Nest& nest : migrants)
+	{
+		values.push_back(nest.GetFitness());
+		values.push_back(nest.GetLambda());
+		values.insert(values.end(), std::begin(nest.GetSolutionsRef()), std::end(nest.GetSolutionsRef()));
+	}
+	std::vector<char> message(sizeof(header) + values.size() * sizeof(double));
+	std::memcpy(message.data(), header, sizeof(header));
+	if (!values.empty())
+	{
+		std::memcpy(message.data() + sizeof(header), values.data(), values.size() * sizeof(double));
+	}
+
+	//Sends and receives are interleaved by poll: blocking sends of all islands
+	//would deadlock, when messages don't fit into socket buffers
+	std::vector<size_t> sent(m_target_sockets.size(), 0);
+	std::vector<std::vector<char>> incoming(m_source_sockets.size(), std::vector<char>(sizeof(header)));
+	std::vector<size_t> received_bytes(m_source_sockets.size(), 0);
+	std::vector<bool> has_header(m_source_sockets.size(), false);
+	std::vector<pollfd> descriptors;
+	std::vector<size_t> channels;
+	while (true)
+	{
+		descriptors.clear();
+		channels.clear();
+		for (size_t i = 0; i < m_target_sockets.size(); ++i)
+		{
+			if (sent[i] < message.size())
+			{
+				descriptors.push_back({ m_target_sockets[i], POLLOUT, 0 });
+				channels.push_back(i);
+			}
+		}
+		const size_t sending = descriptors.size();
+		for (size_t i = 0; i < m_source_sockets.size(); ++i)
+		{
+			if (received_bytes[i] < incoming[i].size())
+			{
+				descriptors.push_back({ m_source_sockets[i], POLLIN, 0 });
+				channels.push_back(i);
+			}
+		}
+		if (descriptors.empty())
+			break;
+
+		if (::poll(descriptors.data(), static_cast<nfds_t>(descriptors.size()), -1) < 0)
+		{
+			if (errno == EINTR)
+				continue;
+			throw std::runtime_error("Can't wait for islands: " + std::string(std::strerror(errno)) + "\n");
+		}
+		for (size_t d = 0; d < descriptors.size(); ++d)
+		{
+			if (descriptors[d].revents == 0)
+				continue;
+			const size_t i = channels[d];
+			if (d < sending)
+			{
+				const ssize_t written = ::send(descriptors[d].fd, message.data() + sent[i], message.size() - sent[i], MSG_NOSIGNAL | MSG_DONTWAIT);
+				if (written < 0)
+				{
+					if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+						continue;
+					throw std::runtime_error("Can't send migrants: " + std::string(std::strerror(errno)) + "\n");
+				}
+				sent[i] += static_cast<size_t>(written);
+				continue;
+			}
+
+			std::vector<char>& buffer = incoming[i];
+			const ssize_t received = ::recv(descriptors[d].fd, buffer.data() + received_bytes[i], buffer.size() - received_bytes[i], MSG_DONTWAIT);
+			if (received == 0)
+				throw std::runtime_error("Island closed connection\n");
+			if (received < 0)
+			{
+				if (errno == EINTR || errno == EAGAIN || errno == EWOULDBLOCK)
+					continue;
+				throw std::runtime_error("Can't receive migrants: " + std::string(std::strerror(errno)) + "\n");
+			}
+			received_bytes[i] += static_cast<size_t>(received);
+			if (!has_header[i] && received_bytes[i] == sizeof(header))
+			{
+				//Size of nests is known after header
+				std::uint32_t source_header[2];
+				std::memcpy(source_header, buffer.data(), sizeof(source_header));
+				buffer.resize(sizeof(header) + size_t(source_header[0]) * (source_header[1] + 2) * sizeof(double));
+				has_header[i] = true;
+			}
+		}
+	}
+
+	std::vector<Nest> received;
+	for (const std::vector<char>& buffer : incoming)
+	{
+		std::uint32_t source_header[2];
+		std::memcpy(source_header, buffer.data(), sizeof(source_header));
+		const std::uint32_t dimensions = source_header[1];
+		std::vector<double> nests(size_t(source_header[0]) * (dimensions + 2));
+		if (!nests.empty())
+		{
+			std::memcpy(nests.data(), buffer.data() + sizeof(source_header), nests.size() * sizeof(double));
+		}
+		for (std::uint32_t i = 0; i < source_header[0]; ++i)
+		{
+			const double* nest = &nests[size_t(i) * (dimensions + 2)];
+			received.push_back(Nest(Egg(nest + 2, dimensions), nest[0], nest[1]));
+		}
+	}
+	return received;
+};
+
+std::string LocalSocketTransport::GetSocketPath(unsigned int rank) const
+{
+	return m_path_prefix + std::to_string(rank);
+};
+
+int LocalSocketTransport::ConnectTo(unsigned int rank, unsigned int timeout_seconds)
+{
+	sockaddr_un address;
+	std::memset(&address, 0, sizeof(address));
+	address.sun_family = AF_UNIX;
+	std::strcpy(address.sun_path, GetSocketPath(rank).c_str());
+
+	//Other process can be not started yet
+	const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(timeout_seconds);
+	while (true)
+	{
+		const int socket = ::socket(AF_UNIX, SOCK_STREAM, 0);
+		if (socket < 0)
+			throw std::runtime_error("Can't create socket: " + std::string(std::strerror(errno)) + "\n");
+		if (::connect(socket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) == 0)
+			return socket;
+		::close(socket);
+		if (std::chrono::steady_clock::now() > deadline)
+			throw std::runtime_error("Can't connect to island " + std::to_string(rank) + "\n");
+		std::this_thread::sleep_for(std::chrono::milliseconds(50));
+	}
+};
+
+void LocalSocketTransport::Close()
+{
+	for (int socket : m_target_sockets)
+	{
+		::close(socket);
+	}
+	for (int socket : m_source_sockets)
+	{
+		if (socket >= 0)
+		{
+			::close(socket);
+		}
+	}
+	m_target_sockets.clear();
+	m_source_sockets.clear();
+	if (m_listen_socket >= 0)
+	{
+		::close(m_listen_socket);
+		::unlink(GetSocketPath(m_rank).c_str());
+		m_listen_socket = -1;
+	}
+};
+
+#else
+
+LocalSocketTransport::LocalSocketTransport(const std::string& path_prefix, unsigned int rank, unsigned int size,
+	MigrationTopology topology, unsigned int connect_timeout_seconds) :
+	m_path_prefix(path_prefix), m_rank(rank), m_size(size), m_listen_socket(-1)
+{
+	throw std::runtime_error("Local socket transport isn't supported on Windows\n");
+};
+
+LocalSocketTransport::~LocalSocketTransport() {};
+
+std::vector<Nest> LocalSocketTransport::Exchange(const std::vector<Nest>& migrants)
+{
+	return std::vector<Nest>();
+};
+
+std::string LocalSocketTransport::GetSocketPath(unsigned int rank) const
+{
+	return m_path_prefix + std::to_string(rank);
+};
+
+int LocalSocketTransport::ConnectTo(unsigned int rank, unsigned int timeout_seconds)
+{
+	return -1;
+};
+
+void LocalSocketTransport::Close() {};
+
+#endif
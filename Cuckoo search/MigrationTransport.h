@@ -0,0 +1,69 @@
+/*
+	Description:
+		Transport of migrants between islands, which work in different processes.
+		MigrationTopology - which islands get migrants of island:
+		RING - next island, ALL_TO_ALL - all other islands.
+		MigrationTransport - interface: Exchange sends migrants of this process
+		to its targets and returns migrants of its sources.
+		LocalSocketTransport - processes on one machine, which are connected by
+		unix domain sockets (socket of island i is path_prefix + i). All processes
+		have to be started with the same size, topology and path prefix.
+		Nest is sent as: fitness, lambda, coordinates (doubles in native byte order).
+*/
+
+#ifndef MIGRATION_TRANSPORT
+#define MIGRATION_TRANSPORT
+
+#include "Nest.h"
+
+#include <vector>
+#include <string>
+
+enum class MigrationTopology
+{
+	RING,
+	ALL_TO_ALL
+};
+
+//Islands, which receive migrants of island
+std::vector<unsigned int> GetMigrationTargets(MigrationTopology topology, unsigned int island, unsigned int islands);
+//Islands, which send migrants to island
+std::vector<unsigned int> GetMigrationSources(MigrationTopology topology, unsigned int island, unsigned int islands);
+
+class MigrationTransport
+{
+public:
+	virtual ~MigrationTransport() {};
+	virtual std::vector<Nest> Exchange(const std::vector<Nest>& migrants) = 0;
+	virtual unsigned int GetRank() const = 0;
+	virtual unsigned int GetSize() const = 0;
+};
+
+class LocalSocketTransport : public MigrationTransport
+{
+public:
+	LocalSocketTransport(const std::string& path_prefix, unsigned int rank, unsigned int size,
+		MigrationTopology topology = MigrationTopology::RING, unsigned int connect_timeout_seconds = 60);
+	virtual ~LocalSocketTransport();
+
+	virtual std::vector<Nest> Exchange(const std::vector<Nest>& migrants);
+	inline virtual unsigned int GetRank() const { return m_rank; };
+	inline virtual unsigned int GetSize() const { return m_size; };
+
+private:
+	std::string			m_path_prefix;
+	unsigned int		m_rank;
+	unsigned int		m_size;
+	int					m_listen_socket;
+	std::vector<int>	m_target_sockets;
+	std::vector<int>	m_source_sockets;
+
+	LocalSocketTransport(const LocalSocketTransport&) = delete;
+	LocalSocketTransport& operator=(const LocalSocketTransport&) = delete;
+
+	std::string GetSocketPath(unsigned int rank) const;
+	int ConnectTo(unsigned int rank, unsigned int timeout_seconds);
+	void Close();
+};
+
+#endif // !MIGRATION_TRANSPORT
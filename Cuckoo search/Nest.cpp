@@ -1,60 +1,46 @@
 #include "Nest.h"
 
 
-Nest::Nest(const ObjectiveFunction& func, double lambda)
+Nest::Nest(const ObjectiveFunction& func, RandomEngine& random_engine, double lambda) :
+	m_lambda(lambda)
 {
-	m_bounds = func.GetBounds();
-	GenerateInitialSolutions();
+	GenerateInitialSolutions(func.GetBounds(), random_engine);
 	m_fitness = func(m_solutions);
-	m_alpha = std::valarray<double>(1.0, m_solutions.size());
 };
 
 Nest::Nest(const ObjectiveFunction& func, const Egg& host_nest, double lambda) :
 	 m_solutions(host_nest), m_lambda(lambda)
 {
-	m_bounds = func.GetBounds();
-	BoundedSolutions();
+	BoundedSolutions(func.GetBounds());
 	m_fitness = func(m_solutions);
-	m_alpha = std::valarray<double>(1.0, m_solutions.size());
 };
 
 Nest::Nest(const ObjectiveFunction& func, const Bounds& bounds, const Egg& host_nest, double lambda):
 	m_solutions(host_nest), m_lambda(lambda)
 {
-	m_bounds = std::vector<Bounds>(m_solutions.size(), bounds);
-	BoundedSolutions();
+	BoundedSolutions(std::vector<Bounds>(m_solutions.size(), bounds));
 	m_fitness = func(m_solutions);
-	m_alpha = std::valarray<double>(1.0, m_solutions.size());
 };
 
 Nest::Nest(const ObjectiveFunction& func, const std::vector<Bounds>& bounds, const Egg& host_nest, double lambda):
-	m_solutions(host_nest), m_bounds(bounds), m_lambda(lambda)
+	m_solutions(host_nest), m_lambda(lambda)
 {
-	BoundedSolutions();
+	BoundedSolutions(bounds);
 	m_fitness = func(m_solutions);
-	m_alpha = std::valarray<double>(1.0, m_solutions.size());
 };
 
-Nest::Nest(const Nest& nest)
-{
-	if (&nest == this)
-		return;
-	m_solutions = nest.m_solutions;
-	m_bounds = nest.m_bounds;
-	m_alpha = nest.m_alpha;
-	m_fitness = nest.m_fitness;
-};
+Nest::Nest(const Egg& solution, double fitness, double lambda) :
+	m_solutions(solution), m_fitness(fitness), m_lambda(lambda) { };
 
-Nest& Nest::operator=(const Nest& nest)
+void Nest::Assign(const double* solution, unsigned int dimensions, double fitness, double lambda)
 {
-	if (&nest == this)
-		return *this;
-
-	m_solutions = nest.m_solutions;
-	m_bounds = nest.m_bounds;
-	m_alpha = nest.m_alpha;
-	m_fitness = nest.m_fitness;
-	return *this;
+	if (m_solutions.size() != dimensions)
+	{
+		m_solutions.resize(dimensions);
+	}
+	std::copy(solution, solution + dimensions, std::begin(m_solutions));
+	m_fitness = fitness;
+	m_lambda = lambda;
 };
 
 bool Nest::operator<(const Nest& rs) const
@@ -80,39 +66,27 @@ bool Nest::operator>=(const Nest& rs) const
 void Nest::SetLambda(double lambda)
 {
 	if ((lambda <= 0.1) || (lambda >= 2))
-		throw std::exception("Lambda must be in range [0.1, 1.99]\n");
+		throw std::runtime_error("Lambda must be in range [0.1, 1.99]\n");
 	m_lambda = lambda;
 };
 
-void Nest::SetAlpha(double alpha)
-{
-	SetAlpha(std::valarray<double>(alpha, m_solutions.size()));
-};
-
-void Nest::SetAlpha(const std::valarray<double>& alpha)
-{
-	if (std::find_if(std::begin(alpha), std::end(alpha), [](double elem) {return (elem <= 0.0); }) != std::end(alpha))
-		throw std::exception("Alpha must be more than 0\n");
-	m_alpha = alpha;
-};
-
-void Nest::GenerateInitialSolutions()
+void Nest::GenerateInitialSolutions(const std::vector<Bounds>& bounds, RandomEngine& random_engine)
 {
-	m_solutions = std::valarray<double>(m_bounds.size());
-	for (size_t i = 0; i < m_bounds.size(); ++i)
+	m_solutions = std::valarray<double>(bounds.size());
+	for (size_t i = 0; i < bounds.size(); ++i)
 	{
-		m_solutions[i] = m_bounds[i].lower_bound + rand() * (m_bounds[i].upper_bound - m_bounds[i].lower_bound) / double(RAND_MAX + 1.0);
+		m_solutions[i] = random_engine.Uniform(bounds[i].lower_bound, bounds[i].upper_bound);
 	}
 };
 
-void Nest::BoundedSolutions()
+void Nest::BoundedSolutions(const std::vector<Bounds>& bounds)
 {
-	for (size_t i = 0; i < m_bounds.size(); ++i)
+	for (size_t i = 0; i < bounds.size(); ++i)
 	{
-		if (m_solutions[i] < m_bounds[i].lower_bound)
-			m_solutions[i] = m_bounds[i].lower_bound;
-		if (m_solutions[i] > m_bounds[i].upper_bound)
-			m_solutions[i] = m_bounds[i].upper_bound;
+		if (m_solutions[i] < bounds[i].lower_bound)
+			m_solutions[i] = bounds[i].lower_bound;
+		if (m_solutions[i] > bounds[i].upper_bound)
+			m_solutions[i] = bounds[i].upper_bound;
 	}
 };
 
@@ -1,7 +1,8 @@
 /*
 	Description:
-		This class saves the current solution and information for 
-		getting next solution.
+		This class saves solution and its fitness.
+		Search keeps its population in Population class, Nest is used for
+		results (best solution) and for single flights.
 */
 
 
@@ -9,11 +10,11 @@
 #define NEST
 
 #include "FunctionHelper.h"
+#include "Random.h"
 
 #include <valarray>
 #include <vector>
-#include <random>
-#include <exception>
+#include <stdexcept>
 #include <algorithm>
 #include <fstream>
 #include <iomanip>
@@ -24,12 +25,11 @@ class Nest
 {
 public:
 	Nest() {};
-	Nest(const ObjectiveFunction& func, double lambda = 0.3);
+	Nest(const ObjectiveFunction& func, RandomEngine& random_engine, double lambda = 0.3);
 	Nest(const ObjectiveFunction& func, const Egg& host_nest, double lambda = 0.3);
 	Nest(const ObjectiveFunction& func, const Bounds& bounds, const Egg& host_nest, double lambda = 0.3);
 	Nest(const ObjectiveFunction& func, const std::vector<Bounds>& bounds, const Egg& host_nest, double lambda = 0.3);
-	Nest& operator=(const Nest& nest);
-	Nest(const Nest& nest);
+	Nest(const Egg& solution, double fitness, double lambda);
 
 	bool operator<(const Nest& rs) const;
 	bool operator>(const Nest& rs) const;
@@ -38,15 +38,12 @@ public:
 
 	inline double GetFitness() const { return m_fitness; };
 	inline std::valarray<double> GetSolutions() const { return m_solutions; };
-	inline std::valarray<double> GetAlpha() const { return m_alpha; };
+	inline const Egg& GetSolutionsRef() const { return m_solutions; };
 	inline double GetLambda() const { return m_lambda; };
-	inline std::vector<Bounds> GetBounds() const { return m_bounds; };
 
-	inline void SetBounds(const std::vector<Bounds>& bounds) { m_bounds = bounds; };
 	void SetLambda(double lambda);
-	void SetAlpha(double alpha);
-	void SetAlpha(const std::valarray<double>& alpha);
-	void SetBounds(const Bounds& bounds) { m_bounds = std::vector<Bounds>(m_solutions.size(), bounds); };
+	//Copies solution, memory is allocated only if number of dimensions is changed
+	void Assign(const double* solution, unsigned int dimensions, double fitness, double lambda);
 	
 	friend std::ostream& operator<<(std::ostream& stream, Nest& nest);
 
@@ -54,13 +51,12 @@ private:
 	Egg						m_solutions;
 	double					m_fitness;
 	double					m_lambda;
-	std::valarray<double>	m_alpha;
-	std::vector<Bounds>		m_bounds;
 
-	void GenerateInitialSolutions();
-	void BoundedSolutions();
+	void GenerateInitialSolutions(const std::vector<Bounds>& bounds, RandomEngine& random_engine);
+	void BoundedSolutions(const std::vector<Bounds>& bounds);
 };
 
-using CompareFitness = std::function<bool(const Nest&, const Nest&)>;
+//Returns true if left fitness is better than right
+using CompareFitness = std::function<bool(double, double)>;
 
 #endif // !NEST
@@ -0,0 +1,98 @@
+#include "OnlineStatistics.h"
+
+#include <algorithm>
+#include <limits>
+
+void ConvergenceStatistics::Reset(unsigned int iterations, unsigned int dimensions, unsigned int points, unsigned int tests)
+{
+	m_iterations = iterations;
+	m_dimensions = dimensions;
+	m_step = std::max(1u, iterations / std::max(1u, points));
+	m_checkpoints_per_test = (iterations + m_step - 1) / m_step;
+	m_fitness.assign(iterations, RunningStatistics());
+	m_mean_solutions.assign(size_t(iterations) * dimensions, 0.0);
+	//Checkpoints of unfinished tests stay NaN
+	m_checkpoints.assign(size_t(tests) * m_checkpoints_per_test, std::numeric_limits<double>::quiet_NaN());
+};
+
+void ConvergenceStatistics::Add(unsigned int test, unsigned int generation, double fitness, const double* solution)
+{
+	if (generation >= m_iterations)
+		return;
+
+	RunningStatistics& statistics = m_fitness[generation];
+	statistics.Add(fitness);
+	double* mean_solution = &m_mean_solutions[size_t(generation) * m_dimensions];
+	const double weight = 1.0 / double(statistics.GetCount());
+	for (unsigned int k = 0; k < m_dimensions; ++k)
+	{
+		mean_solution[k] += (solution[k] - mean_solution[k]) * weight;
+	}
+
+	const size_t checkpoint = size_t(test) * m_checkpoints_per_test + generation / m_step;
+	if (generation % m_step == 0 && checkpoint < m_checkpoints.size())
+	{
+		m_checkpoints[checkpoint] = fitness;
+	}
+};
+
+ConvergenceTrace ConvergenceStatistics::GetAverageTrace(const TraceHeader& header) const
+{
+	ConvergenceTrace trace;
+	trace.header = header;
+	trace.header.dimensions = m_dimensions;
+	for (unsigned int generation = 0; generation < m_iterations && m_fitness[generation].GetCount() > 0; ++generation)
+	{
+		trace.generations.push_back(generation);
+		trace.fitness.push_back(m_fitness[generation].GetMean());
+	}
+	trace.solutions.assign(m_mean_solutions.begin(), m_mean_solutions.begin() + trace.GetSize() * m_dimensions);
+	return trace;
+};
+
+ConvergenceTrace ConvergenceStatistics::GetDeviationTrace(const TraceHeader& header) const
+{
+	ConvergenceTrace trace;
+	trace.header = header;
+	trace.header.dimensions = 0;
+	for (unsigned int generation = 0; generation < m_iterations && m_fitness[generation].GetCount() > 0; ++generation)
+	{
+		trace.generations.push_back(generation);
+		trace.fitness.push_back(m_fitness[generation].GetStdDeviation());
+	}
+	return trace;
+};
+
+ConvergenceTrace ConvergenceStatistics::GetCheckpointTrace(const TraceHeader& header, unsigned int test) const
+{
+	ConvergenceTrace trace;
+	trace.header = header;
+	trace.header.dimensions = 0;
+	for (unsigned int i = 0; i < m_checkpoints_per_test; ++i)
+	{
+		const double fitness = m_checkpoints[size_t(test) * m_checkpoints_per_test + i];
+		if (std::isnan(fitness))
+			break;
+		trace.generations.push_back(i * m_step);
+		trace.fitness.push_back(fitness);
+	}
+	return trace;
+};
+
+int TraceReservoir::Offer(unsigned int test)
+{
+	++m_offered;
+	if (m_size == 0 || m_tests.size() < m_size)
+	{
+		m_tests.push_back(test);
+		return -1;
+	}
+
+	//Algorithm R: test replaces random test of reservoir with probability size / offered
+	const unsigned int index = m_random_engine.UniformIndex(m_offered);
+	if (index >= m_size)
+		return static_cast<int>(test);
+	const unsigned int dropped = m_tests[index];
+	m_tests[index] = test;
+	return static_cast<int>(dropped);
+};
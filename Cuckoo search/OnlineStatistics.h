@@ -0,0 +1,97 @@
+/*
+	Description:
+		Constant-memory statistics of advanced tests.
+		RunningStatistics - Welford's online mean and variance.
+		ConvergenceStatistics - statistics of best ever nest for each generation over tests:
+		fitness mean/variance and mean solution (memory ~ iterations x dimensions,
+		doesn't depend on number of tests) and fitness of each test in checkpoints
+		(generations 0, step, 2 * step, ..., step = iterations / points).
+		TraceReservoir - chooses tests, which keep full traces, by reservoir sampling:
+		each test is kept with the same probability size / tests.
+*/
+
+#ifndef ONLINE_STATISTICS
+#define ONLINE_STATISTICS
+
+#include "ConvergenceTrace.h"
+#include "Random.h"
+
+#include <vector>
+#include <cmath>
+#include <cstdint>
+
+class RunningStatistics
+{
+public:
+	RunningStatistics() :
+		m_count(0), m_mean(0.0), m_m2(0.0) {};
+
+	inline void Add(double value)
+	{
+		++m_count;
+		const double delta = value - m_mean;
+		m_mean += delta / double(m_count);
+		m_m2 += delta * (value - m_mean);
+	};
+
+	inline std::uint64_t GetCount() const { return m_count; };
+	inline double GetMean() const { return m_mean; };
+	//Sample variance
+	inline double GetVariance() const { return (m_count > 1) ? m_m2 / double(m_count - 1) : 0.0; };
+	inline double GetStdDeviation() const { return std::sqrt(GetVariance()); };
+
+private:
+	std::uint64_t	m_count;
+	double			m_mean;
+	double			m_m2;
+};
+
+class ConvergenceStatistics
+{
+public:
+	ConvergenceStatistics() :
+		m_iterations(0), m_dimensions(0), m_step(1) {};
+
+	void Reset(unsigned int iterations, unsigned int dimensions, unsigned int points, unsigned int tests);
+	void Add(unsigned int test, unsigned int generation, double fitness, const double* solution);
+
+	inline const RunningStatistics& GetFitnessStatistics(unsigned int generation) const { return m_fitness[generation]; };
+	inline unsigned int GetCheckpointStep() const { return m_step; };
+	//Trace of mean fitness and mean solution
+	ConvergenceTrace GetAverageTrace(const TraceHeader& header) const;
+	//Trace of standard deviation of fitness (without solutions)
+	ConvergenceTrace GetDeviationTrace(const TraceHeader& header) const;
+	//Checkpoints of one test (without solutions)
+	ConvergenceTrace GetCheckpointTrace(const TraceHeader& header, unsigned int test) const;
+
+private:
+	unsigned int					m_iterations;
+	unsigned int					m_dimensions;
+	unsigned int					m_step;
+	std::vector<RunningStatistics>	m_fitness;
+	//Row-major matrix: generations x dimensions
+	std::vector<double>				m_mean_solutions;
+	//Row-major matrix: tests x checkpoints
+	std::vector<double>				m_checkpoints;
+	unsigned int					m_checkpoints_per_test;
+};
+
+class TraceReservoir
+{
+public:
+	//size = 0 - all tests are kept
+	TraceReservoir(unsigned int size = 0, std::uint64_t seed = 0) :
+		m_size(size), m_offered(0), m_random_engine(seed) {};
+
+	//Returns test, which has to be dropped (offered test or test from reservoir), or -1
+	int Offer(unsigned int test);
+	inline const std::vector<unsigned int>& GetTests() const { return m_tests; };
+
+private:
+	unsigned int				m_size;
+	unsigned int				m_offered;
+	std::vector<unsigned int>	m_tests;
+	RandomEngine				m_random_engine;
+};
+
+#endif // !ONLINE_STATISTICS
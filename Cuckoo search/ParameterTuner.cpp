@@ -0,0 +1,199 @@
+#include "ParameterTuner.h"
+#include "TrialHarness.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <stdexcept>
+#include <thread>
+
+//The shortest run: initial population and this number of generations
+const unsigned int MIN_RUN_GENERATIONS = 10;
+//Stream of random candidates (streams of trials are their numbers)
+const std::uint64_t CANDIDATES_STREAM = std::uint64_t(1) << 32;
+
+ParameterTuner::ParameterTuner(const CuckooSearch& cuckoo_search, unsigned long long total_evaluations) :
+	m_cuckoo_search(cuckoo_search), m_total_evaluations(total_evaluations), m_candidates(27), m_reduction(3), m_trials(3),
+	m_seed(1), m_threads(0), m_step_range({ 1e-7, 1e-1 }), m_lambda_range({ 0.3, 1.99 }), m_probability_range({ 0.05, 0.5 })
+{
+	//Runs of tuner are distributed between threads, search of each run runs on its thread
+	m_cuckoo_search.SetNumberOfThreads(1);
+};
+
+const TuningResult& ParameterTuner::TuneMin()
+{
+	return Tune(true);
+};
+
+const TuningResult& ParameterTuner::TuneMax()
+{
+	return Tune(false);
+};
+
+std::vector<TuningCandidate> ParameterTuner::CreateCandidates(unsigned int count) const
+{
+	std::vector<TuningCandidate> candidates(count);
+	//The first candidate is configuration of search
+	const CuckooSearch& cs = m_cuckoo_search;
+	candidates[0].parameters = { cs.GetStep().GetMinStep()[0], cs.GetStep().GetMaxStep()[0],
+		cs.GetLambda().GetMinLambda(), cs.GetLambda().GetMaxLamda(), cs.GetAbandonProbability() };
+
+	RandomEngine random(m_seed, CANDIDATES_STREAM);
+	const double log_min_step = std::log(m_step_range.lower_bound);
+	const double log_max_step = std::log(m_step_range.upper_bound);
+	for (unsigned int i = 1; i < count; ++i)
+	{
+		TunedParameters& parameters = candidates[i].parameters;
+		const double step_a = std::exp(random.Uniform(log_min_step, log_max_step));
+		const double step_b = std::exp(random.Uniform(log_min_step, log_max_step));
+		const double lambda_a = random.Uniform(m_lambda_range.lower_bound, m_lambda_range.upper_bound);
+		const double lambda_b = random.Uniform(m_lambda_range.lower_bound, m_lambda_range.upper_bound);
+		parameters.min_step = std::min(step_a, step_b);
+		parameters.max_step = std::max(step_a, step_b);
+		parameters.min_lambda = std::min(lambda_a, lambda_b);
+		parameters.max_lambda = std::max(lambda_a, lambda_b);
+		parameters.abandon_probability = random.Uniform(m_probability_range.lower_bound, m_probability_range.upper_bound);
+	}
+	for (unsigned int i = 0; i < count; ++i)
+	{
+		candidates[i].id = i;
+		candidates[i].rounds = 0;
+		candidates[i].score = 0.0;
+	}
+	return candidates;
+};
+
+std::vector<unsigned int> ParameterTuner::GetRounds(unsigned int candidates) const
+{
+	std::vector<unsigned int> rounds;
+	for (unsigned int count = candidates; count > 1; count = std::max(1u, count / m_reduction))
+	{
+		rounds.push_back(count);
+	}
+	if (rounds.empty())
+	{
+		rounds.push_back(1);
+	}
+	return rounds;
+};
+
+double ParameterTuner::RunCandidate(const TuningCandidate& candidate, unsigned int trial, unsigned long long evaluations,
+	bool minimize, unsigned long long& used_evaluations) const
+{
+	const TunedParameters& parameters = candidate.parameters;
+	const unsigned int dimensions = m_cuckoo_search.GetObjectiveFunction().GetNumberOfDimensions();
+	CuckooSearch cuckoo_search(m_cuckoo_search);
+	cuckoo_search.SetStep(Step(parameters.min_step, parameters.max_step, dimensions));
+	cuckoo_search.SetLamda({ parameters.min_lambda, parameters.max_lambda });
+	cuckoo_search.SetAbandonProbability(parameters.abandon_probability);
+	SearchBudget budget;
+	budget.SetMaxEvaluations(evaluations);
+	cuckoo_search.SetBudget(budget);
+	//Short runs of candidates aren't resumed, and parallel runs would overwrite checkpoints of each other
+	cuckoo_search.SetCheckpointing(std::string(), 0);
+
+	//Trial t has the same seed for all candidates
+	const TrialResult result = TrialHarness(cuckoo_search, m_trials, m_seed).RunTrial(trial, minimize);
+	used_evaluations = result.evaluations;
+	return result.best_fitness;
+};
+
+const TuningResult& ParameterTuner::Tune(bool minimize)
+{
+	const auto start_time = std::chrono::steady_clock::now();
+	const unsigned long long min_run_evaluations = static_cast<unsigned long long>(m_cuckoo_search.GetNumberOfNests()) * (MIN_RUN_GENERATIONS + 1);
+
+	//Candidates are dropped, while runs of the first round are too short
+	unsigned int count = m_candidates;
+	while (count > 1 && m_total_evaluations / (GetRounds(count).size() * count * m_trials) < min_run_evaluations)
+	{
+		--count;
+	}
+	if (m_total_evaluations / m_trials < min_run_evaluations)
+		throw std::runtime_error("Budget of tuning is less than " + std::to_string(min_run_evaluations * m_trials) + " evaluations\n");
+
+	std::vector<TuningCandidate> candidates = CreateCandidates(count);
+	const std::vector<unsigned int> rounds = GetRounds(count);
+	const unsigned long long round_evaluations = m_total_evaluations / rounds.size();
+	auto is_better = [minimize](const TuningCandidate& ls, const TuningCandidate& rs)
+	{
+		if (ls.rounds != rs.rounds)
+			return ls.rounds > rs.rounds;
+		if (ls.score != rs.score)
+			return minimize ? ls.score < rs.score : ls.score > rs.score;
+		return ls.id < rs.id;
+	};
+
+	m_result = TuningResult();
+	m_result.evaluations = 0;
+	const unsigned int threads = (m_threads == 0) ? std::thread::hardware_concurrency() : m_threads;
+	for (unsigned int round = 0; round < rounds.size(); ++round)
+	{
+		//The first rounds[round] candidates remain
+		const unsigned int size = rounds[round];
+		const unsigned long long run_evaluations = round_evaluations / (static_cast<unsigned long long>(size) * m_trials);
+		const unsigned int runs = size * m_trials;
+		std::vector<double> fitness(runs);
+		std::vector<unsigned long long> used_evaluations(runs);
+
+		std::shared_ptr<Executor> executor = Executor::Create(std::max(1u, std::min(threads, runs)));
+		executor->ParallelFor(0, runs, [&](unsigned int run)
+		{
+			fitness[run] = RunCandidate(candidates[run / m_trials], run % m_trials, run_evaluations, minimize, used_evaluations[run]);
+		});
+
+		for (unsigned int i = 0; i < size; ++i)
+		{
+			std::vector<double> trials(fitness.begin() + i * m_trials, fitness.begin() + (i + 1) * m_trials);
+			std::sort(trials.begin(), trials.end());
+			const size_t middle = trials.size() / 2;
+			candidates[i].score = (trials.size() % 2) ? trials[middle] : (trials[middle - 1] + trials[middle]) / 2.0;
+			candidates[i].rounds = round + 1;
+		}
+		for (unsigned long long evaluations : used_evaluations)
+		{
+			m_result.evaluations += evaluations;
+		}
+		std::sort(candidates.begin(), candidates.end(), is_better);
+		m_result.rounds.push_back({ size, run_evaluations, candidates[0].score });
+	}
+
+	m_result.best = candidates[0].parameters;
+	m_result.best_score = candidates[0].score;
+	m_result.candidates = candidates;
+	m_result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	return m_result;
+};
+
+void ParameterTuner::WriteResult(std::ostream& o_stream) const
+{
+	o_stream << m_cuckoo_search.GetObjectiveFunction().GetName() << ": " << m_result.candidates.size() << " candidates, " <<
+		m_result.rounds.size() << " rounds, " << m_result.evaluations << " evaluations, " << m_result.wall_seconds << " s\n";
+	for (size_t i = 0; i < m_result.rounds.size(); ++i)
+	{
+		const TuningRound& round = m_result.rounds[i];
+		o_stream << "Round " << i + 1 << ": " << round.candidates << " candidates, " << round.run_evaluations <<
+			" evaluations per run, best median = " << round.best_score << "\n";
+	}
+	o_stream << "id,rounds,score,min_step,max_step,min_lambda,max_lambda,abandon_probability\n";
+	for (const TuningCandidate& candidate : m_result.candidates)
+	{
+		const TunedParameters& parameters = candidate.parameters;
+		o_stream << candidate.id << "," << candidate.rounds << "," << candidate.score << "," << parameters.min_step << "," <<
+			parameters.max_step << "," << parameters.min_lambda << "," << parameters.max_lambda << "," << parameters.abandon_probability << "\n";
+	}
+};
+
+void ParameterTuner::WriteParameters(std::ostream& o_stream, const std::string& name) const
+{
+	const TunedParameters& best = m_result.best;
+	const std::streamsize precision = o_stream.precision(std::numeric_limits<double>::max_digits10);
+	o_stream << "[" << name << "]\n";
+	o_stream << "min_step = " << best.min_step << "\n";
+	o_stream << "max_step = " << best.max_step << "\n";
+	o_stream << "min_lambda = " << best.min_lambda << "\n";
+	o_stream << "max_lambda = " << best.max_lambda << "\n";
+	o_stream << "abandon_probability = " << best.abandon_probability << "\n";
+	o_stream.precision(precision);
+};
@@ -0,0 +1,109 @@
+/*
+	Description:
+		Tuner of step (min/max), lambda (min/max) and abandon probability of CuckooSearch
+		by successive halving. Candidates are the configuration of given search and
+		random configurations from ranges (steps are sampled log-uniformly).
+		Each round runs several trials of every remaining candidate as short searches
+		with budget of evaluations, keeps the best 1 / reduction candidates by median
+		of best fitness and gives them longer runs in the next round.
+		All rounds get equal parts of total budget, so tuning uses at most total evaluations.
+		Trial t of all candidates uses the same seed, so candidates are compared on the same
+		random streams. Runs of round are distributed between threads, search of each run
+		runs on its thread. Result doesn't depend on number of threads.
+		Tuned parameters are written as parameter set of experiment file (ExperimentRunner.h).
+*/
+
+#ifndef PARAMETER_TUNER
+#define PARAMETER_TUNER
+
+#include "CuckooSearch.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+struct TunedParameters
+{
+	double	min_step;
+	double	max_step;
+	double	min_lambda;
+	double	max_lambda;
+	double	abandon_probability;
+};
+
+struct TuningCandidate
+{
+	unsigned int	id;
+	TunedParameters	parameters;
+	//Rounds, which candidate passed
+	unsigned int	rounds;
+	//Median of best fitness in the last round of candidate
+	double			score;
+};
+
+struct TuningRound
+{
+	unsigned int		candidates;
+	unsigned long long	run_evaluations;
+	double				best_score;
+};
+
+struct TuningResult
+{
+	TunedParameters				best;
+	double						best_score;
+	//Candidates are ordered from the best one
+	std::vector<TuningCandidate>	candidates;
+	std::vector<TuningRound>	rounds;
+	unsigned long long			evaluations;
+	double						wall_seconds;
+};
+
+class ParameterTuner
+{
+public:
+	//Number of dimensions, nests, lazy cuckoo and subspace flights are taken from search
+	ParameterTuner(const CuckooSearch& cuckoo_search, unsigned long long total_evaluations);
+
+	const TuningResult& TuneMin();
+	const TuningResult& TuneMax();
+
+	//Table of candidates and rounds
+	void WriteResult(std::ostream& o_stream) const;
+	//Best parameters as section of experiment file
+	void WriteParameters(std::ostream& o_stream, const std::string& name) const;
+
+	inline void SetCandidates(unsigned int candidates) { m_candidates = std::max(1u, candidates); };
+	inline void SetReduction(unsigned int reduction) { m_reduction = std::max(2u, reduction); };
+	inline void SetTrials(unsigned int trials) { m_trials = std::max(1u, trials); };
+	inline void SetSeed(std::uint64_t seed) { m_seed = seed; };
+	//threads = 0 - all hardware threads
+	inline void SetThreads(unsigned int threads) { m_threads = threads; };
+	inline void SetStepRange(double min_step, double max_step) { m_step_range = { min_step, max_step }; };
+	inline void SetLambdaRange(double min_lambda, double max_lambda) { m_lambda_range = { min_lambda, max_lambda }; };
+	inline void SetProbabilityRange(double min_probability, double max_probability) { m_probability_range = { min_probability, max_probability }; };
+	inline const TuningResult& GetResult() const { return m_result; };
+
+private:
+	CuckooSearch		m_cuckoo_search;
+	unsigned long long	m_total_evaluations;
+	unsigned int		m_candidates;
+	unsigned int		m_reduction;
+	unsigned int		m_trials;
+	std::uint64_t		m_seed;
+	unsigned int		m_threads;
+	Bounds				m_step_range;
+	Bounds				m_lambda_range;
+	Bounds				m_probability_range;
+	TuningResult		m_result;
+
+	const TuningResult& Tune(bool minimize);
+	std::vector<TuningCandidate> CreateCandidates(unsigned int count) const;
+	//Numbers of candidates in rounds
+	std::vector<unsigned int> GetRounds(unsigned int candidates) const;
+	double RunCandidate(const TuningCandidate& candidate, unsigned int trial, unsigned long long evaluations,
+		bool minimize, unsigned long long& used_evaluations) const;
+};
+
+#endif // !PARAMETER_TUNER
@@ -0,0 +1,68 @@
+#include "Population.h"
+
+#include <algorithm>
+
+Population::Population(unsigned int size, unsigned int dimensions) :
+	m_size(0), m_dimensions(0), m_stride(0)
+{
+	Resize(size, dimensions);
+};
+
+void Population::Resize(unsigned int size, unsigned int dimensions)
+{
+	if (size == m_size && dimensions == m_dimensions)
+		return;
+
+	const unsigned int row_alignment = static_cast<unsigned int>(CACHE_LINE_SIZE / sizeof(double));
+	m_size = size;
+	m_dimensions = dimensions;
+	m_stride = (dimensions + row_alignment - 1) / row_alignment * row_alignment;
+
+	m_solutions.assign(size_t(m_size) * m_stride, 0.0);
+	m_fitness.assign(m_size, 0.0);
+	m_lambda.assign(m_size, 1.0);
+};
+
+void Population::SetLambda(unsigned int index, double lambda)
+{
+	if ((lambda <= 0.1) || (lambda >= 2))
+		throw std::runtime_error("Lambda must be in range [0.1, 1.99]\n");
+	m_lambda[index] = lambda;
+};
+
+void Population::Assign(unsigned int index, const double* solution, double fitness)
+{
+	std::copy(solution, solution + m_dimensions, GetSolution(index));
+	m_fitness[index] = fitness;
+};
+
+Egg Population::GetEgg(unsigned int index) const
+{
+	return Egg(GetSolution(index), m_dimensions);
+};
+
+Nest Population::GetNest(unsigned int index) const
+{
+	return Nest(GetEgg(index), m_fitness[index], m_lambda[index]);
+};
+
+void Population::CopyNest(unsigned int index, Nest& nest) const
+{
+	nest.Assign(GetSolution(index), m_dimensions, m_fitness[index], m_lambda[index]);
+};
+
+void Population::GenerateSolution(double* solution, const std::vector<Bounds>& bounds, RandomEngine& random_engine)
+{
+	for (size_t i = 0; i < bounds.size(); ++i)
+	{
+		solution[i] = random_engine.Uniform(bounds[i].lower_bound, bounds[i].upper_bound);
+	}
+};
+
+void Population::BoundSolution(double* solution, const std::vector<Bounds>& bounds)
+{
+	for (size_t i = 0; i < bounds.size(); ++i)
+	{
+		solution[i] = std::min(std::max(solution[i], bounds[i].lower_bound), bounds[i].upper_bound);
+	}
+};
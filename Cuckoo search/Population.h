@@ -0,0 +1,63 @@
+/*
+	Description:
+		Population keeps all nests of search as structure of arrays:
+		solutions - matrix (nests x dimensions), each row starts on cache line
+		(row stride is rounded up), fitness and lambda of nests are kept in separate arrays.
+		Memory is allocated only when size of population changes, so generations
+		work with the same memory and nests are never copied as objects.
+		Rows don't move: order of nests by fitness is kept by Ranking.
+*/
+
+#ifndef POPULATION
+#define POPULATION
+
+#include "FunctionHelper.h"
+#include "Nest.h"
+#include "Random.h"
+#include "Simd.h"
+
+#include <vector>
+#include <valarray>
+
+class Population
+{
+public:
+	Population() :
+		m_size(0), m_dimensions(0), m_stride(0) {};
+	Population(unsigned int size, unsigned int dimensions);
+
+	void Resize(unsigned int size, unsigned int dimensions);
+
+	inline double* GetSolution(unsigned int index) { return &m_solutions[index * m_stride]; };
+	inline const double* GetSolution(unsigned int index) const { return &m_solutions[index * m_stride]; };
+	inline double GetFitness(unsigned int index) const { return m_fitness[index]; };
+	inline double* GetFitnessData() { return &m_fitness[0]; };
+	inline const double* GetFitnessData() const { return &m_fitness[0]; };
+	inline double GetLambda(unsigned int index) const { return m_lambda[index]; };
+	inline unsigned int GetSize() const { return m_size; };
+	inline unsigned int GetDimensions() const { return m_dimensions; };
+	inline unsigned int GetStride() const { return m_stride; };
+
+	inline void SetFitness(unsigned int index, double fitness) { m_fitness[index] = fitness; };
+	void SetLambda(unsigned int index, double lambda);
+
+	//Copies solution into index row
+	void Assign(unsigned int index, const double* solution, double fitness);
+	Egg GetEgg(unsigned int index) const;
+	Nest GetNest(unsigned int index) const;
+	//Copies index row into nest, memory of nest is reused
+	void CopyNest(unsigned int index, Nest& nest) const;
+
+	static void GenerateSolution(double* solution, const std::vector<Bounds>& bounds, RandomEngine& random_engine);
+	static void BoundSolution(double* solution, const std::vector<Bounds>& bounds);
+
+private:
+	AlignedVector			m_solutions;
+	std::vector<double>		m_fitness;
+	std::vector<double>		m_lambda;
+	unsigned int			m_size;
+	unsigned int			m_dimensions;
+	unsigned int			m_stride;
+};
+
+#endif // !POPULATION
@@ -0,0 +1,156 @@
+/*
+	Description:
+		Profiling counters of search: time of phases of generation and counters of
+		evaluations, replacements and abandonments.
+		Instrumentation is compiled only with CUCKOO_PROFILING defined (project settings or
+		compiler option), without it CUCKOO_PROFILE_SCOPE and CUCKOO_PROFILE_COUNT are empty
+		and ProfileData stays zero.
+		Phases are measured on thread, which runs search (around parallel loops), phases don't
+		overlap, so sum of phases is close to time of run.
+*/
+
+#ifndef PROFILING
+#define PROFILING
+
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+#include <iomanip>
+
+enum class ProfilePhase : unsigned int
+{
+	FLIGHT_GENERATION,
+	EVALUATION,
+	CANDIDATE_SELECTION,
+	REPLACEMENT,
+	RANKING,
+	ABANDON,
+	STATISTICS_HANDLER,
+	QUEUE_WAIT,
+	COUNT
+};
+
+enum class ProfileCounter : unsigned int
+{
+	EVALUATIONS,
+	REPLACEMENTS,
+	ABANDONMENTS,
+	COUNT
+};
+
+const unsigned int PROFILE_PHASES = static_cast<unsigned int>(ProfilePhase::COUNT);
+const unsigned int PROFILE_COUNTERS = static_cast<unsigned int>(ProfileCounter::COUNT);
+
+struct ProfileData
+{
+	double			seconds[PROFILE_PHASES];
+	std::uint64_t	calls[PROFILE_PHASES];
+	std::uint64_t	counters[PROFILE_COUNTERS];
+
+	ProfileData() { Reset(); };
+
+	inline void Reset()
+	{
+		for (unsigned int i = 0; i < PROFILE_PHASES; ++i)
+		{
+			seconds[i] = 0.0;
+			calls[i] = 0;
+		}
+		for (unsigned int i = 0; i < PROFILE_COUNTERS; ++i)
+		{
+			counters[i] = 0;
+		}
+	};
+
+	inline void Merge(const ProfileData& profile)
+	{
+		for (unsigned int i = 0; i < PROFILE_PHASES; ++i)
+		{
+			seconds[i] += profile.seconds[i];
+			calls[i] += profile.calls[i];
+		}
+		for (unsigned int i = 0; i < PROFILE_COUNTERS; ++i)
+		{
+			counters[i] += profile.counters[i];
+		}
+	};
+
+	inline double GetSeconds(ProfilePhase phase) const { return seconds[static_cast<unsigned int>(phase)]; };
+	inline std::uint64_t GetCalls(ProfilePhase phase) const { return calls[static_cast<unsigned int>(phase)]; };
+	inline std::uint64_t GetCounter(ProfileCounter counter) const { return counters[static_cast<unsigned int>(counter)]; };
+
+	inline double GetTotalSeconds() const
+	{
+		double total = 0.0;
+		for (unsigned int i = 0; i < PROFILE_PHASES; ++i)
+		{
+			total += seconds[i];
+		}
+		return total;
+	};
+
+	static inline const char* GetPhaseName(unsigned int phase)
+	{
+		static const char* names[PROFILE_PHASES] = { "Flight generation", "Evaluation", "Candidate selection",
+			"Replacement", "Ranking", "Abandon", "Statistics handler", "Queue wait" };
+		return names[phase];
+	};
+
+	static inline const char* GetCounterName(unsigned int counter)
+	{
+		static const char* names[PROFILE_COUNTERS] = { "Evaluations", "Replacements", "Abandonments" };
+		return names[counter];
+	};
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const ProfileData& profile)
+{
+	const double total = profile.GetTotalSeconds();
+	for (unsigned int i = 0; i < PROFILE_PHASES; ++i)
+	{
+		stream << "\t" << ProfileData::GetPhaseName(i) << ": " << profile.seconds[i] << " seconds (" <<
+			std::setprecision(3) << (total > 0.0 ? 100.0 * profile.seconds[i] / total : 0.0) << std::setprecision(6) <<
+			"%), calls: " << profile.calls[i] << "\n";
+	}
+	for (unsigned int i = 0; i < PROFILE_COUNTERS; ++i)
+	{
+		stream << "\t" << ProfileData::GetCounterName(i) << ": " << profile.counters[i] << "\n";
+	}
+	return stream;
+};
+
+#ifdef CUCKOO_PROFILING
+
+class ProfileTimer
+{
+public:
+	ProfileTimer(ProfileData& profile, ProfilePhase phase) :
+		m_profile(profile), m_phase(static_cast<unsigned int>(phase)), m_start(std::chrono::steady_clock::now()) {};
+	~ProfileTimer()
+	{
+		m_profile.seconds[m_phase] += std::chrono::duration<double>(std::chrono::steady_clock::now() - m_start).count();
+		++m_profile.calls[m_phase];
+	};
+
+private:
+	ProfileData&							m_profile;
+	unsigned int							m_phase;
+	std::chrono::steady_clock::time_point	m_start;
+};
+
+const bool PROFILING_ENABLED = true;
+#define CUCKOO_PROFILE_CONCAT_IMPL(name, line) name##line
+#define CUCKOO_PROFILE_CONCAT(name, line) CUCKOO_PROFILE_CONCAT_IMPL(name, line)
+//Measures time from this line to end of scope
+#define CUCKOO_PROFILE_SCOPE(profile, phase) ProfileTimer CUCKOO_PROFILE_CONCAT(profile_timer_, __LINE__)(profile, phase)
+#define CUCKOO_PROFILE_COUNT(profile, counter, value) ((profile).counters[static_cast<unsigned int>(counter)] += (value))
+
+#else
+
+const bool PROFILING_ENABLED = false;
+#define CUCKOO_PROFILE_SCOPE(profile, phase)
+#define CUCKOO_PROFILE_COUNT(profile, counter, value)
+
+#endif // CUCKOO_PROFILING
+
+#endif // !PROFILING
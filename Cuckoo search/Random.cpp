@@ -0,0 +1,81 @@
+#include "Random.h"
+
+#include <cmath>
+#include <random>
+#include <chrono>
+
+static inline std::uint64_t SplitMix64(std::uint64_t& state)
+{
+	std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+	return z ^ (z >> 31);
+};
+
+static inline std::uint64_t RotateLeft(std::uint64_t x, int k)
+{
+	return (x << k) | (x >> (64 - k));
+};
+
+RandomEngine::RandomEngine(std::uint64_t seed, std::uint64_t stream) :
+	m_saved_normal(0.0), m_use_saved_normal(false)
+{
+	std::uint64_t stream_state = stream;
+	std::uint64_t state = seed ^ SplitMix64(stream_state);
+	for (int i = 0; i < 4; ++i)
+	{
+		m_state[i] = SplitMix64(state);
+	}
+};
+
+RandomEngine::result_type RandomEngine::operator()()
+{
+	const std::uint64_t result = RotateLeft(m_state[1] * 5, 7) * 9;
+	const std::uint64_t t = m_state[1] << 17;
+
+	m_state[2] ^= m_state[0];
+	m_state[3] ^= m_state[1];
+	m_state[1] ^= m_state[2];
+	m_state[0] ^= m_state[3];
+	m_state[2] ^= t;
+	m_state[3] = RotateLeft(m_state[3], 45);
+
+	return result;
+};
+
+unsigned int RandomEngine::UniformIndex(unsigned int size)
+{
+	//Multiply-shift mapping, bias is negligible for population sizes
+	return static_cast<unsigned int>((((*this)() >> 32) * size) >> 32);
+};
+
+double RandomEngine::Normal()
+{
+	if (m_use_saved_normal)
+	{
+		m_use_saved_normal = false;
+		return m_saved_normal;
+	}
+
+	double x;
+	double y;
+	double s;
+	do {
+		x = 2.0 * Uniform() - 1.0;
+		y = 2.0 * Uniform() - 1.0;
+		s = x * x + y * y;
+	} while (s >= 1.0 || s == 0.0);
+	const double multiplier = std::sqrt(-2.0 * std::log(s) / s);
+
+	m_saved_normal = y * multiplier;
+	m_use_saved_normal = true;
+	return x * multiplier;
+};
+
+std::uint64_t RandomEngine::GetRandomSeed()
+{
+	std::random_device device;
+	std::uint64_t seed = (std::uint64_t(device()) << 32) ^ device();
+	seed ^= static_cast<std::uint64_t>(std::chrono::high_resolution_clock::now().time_since_epoch().count());
+	return seed;
+};
@@ -0,0 +1,45 @@
+/*
+	Description:
+		Random engine for search engine - xoshiro256** generator.
+		Engine doesn't have shared state, so each thread (or each task) uses own engine.
+		State of engine is derived from pair (seed, stream) by SplitMix64, so
+		any task can get independent engine without sequential jumps:
+		engine for i-cuckoo on t-generation is the same for any number of threads.
+		Normal variables are produced by polar Box-Muller method, second
+		variable is saved for next call.
+*/
+
+#ifndef RANDOM_ENGINE
+#define RANDOM_ENGINE
+
+#include <cstdint>
+#include <limits>
+
+class RandomEngine
+{
+public:
+	using result_type = std::uint64_t;
+
+	RandomEngine(std::uint64_t seed = 0, std::uint64_t stream = 0);
+
+	result_type operator()();
+	static constexpr result_type min() { return 0; };
+	static constexpr result_type max() { return std::numeric_limits<result_type>::max(); };
+
+	//Uniform value in range [0, 1)
+	inline double Uniform() { return ((*this)() >> 11) * (1.0 / 9007199254740992.0); };
+	inline double Uniform(double min, double max) { return min + (max - min) * Uniform(); };
+	//Uniform index in range [0, size)
+	unsigned int UniformIndex(unsigned int size);
+	//Standard normal value
+	double Normal();
+
+	static std::uint64_t GetRandomSeed();
+
+private:
+	std::uint64_t	m_state[4];
+	double			m_saved_normal;
+	bool			m_use_saved_normal;
+};
+
+#endif // !RANDOM_ENGINE
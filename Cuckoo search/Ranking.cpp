@@ -0,0 +1,85 @@
+#include "Ranking.h"
+
+#include <algorithm>
+
+void Ranking::Reset(unsigned int size)
+{
+	m_order.resize(size);
+	m_rank.resize(size);
+	m_is_changed.assign(size, 1);
+	m_changed.resize(size);
+	m_unchanged.reserve(size);
+	for (unsigned int i = 0; i < size; ++i)
+	{
+		m_order[i] = i;
+		m_rank[i] = i;
+		m_changed[i] = i;
+	}
+};
+
+void Ranking::Assign(const std::vector<std::uint32_t>& order)
+{
+	Reset(static_cast<unsigned int>(order.size()));
+	std::vector<char> used(order.size(), 0);
+	for (unsigned int rank = 0; rank < order.size(); ++rank)
+	{
+		if (order[rank] >= order.size() || used[order[rank]])
+			throw std::runtime_error("Order of nests isn't permutation\n");
+		used[order[rank]] = 1;
+		m_order[rank] = order[rank];
+		m_rank[order[rank]] = rank;
+	}
+};
+
+void Ranking::MarkChanged(unsigned int index)
+{
+	if (m_is_changed[index])
+		return;
+	m_is_changed[index] = 1;
+	m_changed.push_back(index);
+};
+
+void Ranking::Update(const double* fitness, const CompareFitness& cmp_fitness)
+{
+	if (m_changed.empty())
+		return;
+
+	auto less = [&](unsigned int ls, unsigned int rs)
+	{
+		if (cmp_fitness(fitness[ls], fitness[rs]))
+			return true;
+		if (cmp_fitness(fitness[rs], fitness[ls]))
+			return false;
+		return ls < rs;
+	};
+
+	const unsigned int size = static_cast<unsigned int>(m_order.size());
+	//Merge doesn't pay off, when almost all nests are changed
+	if (m_changed.size() * 4 >= size * 3)
+	{
+		std::sort(m_order.begin(), m_order.end(), less);
+	}
+	else
+	{
+		m_unchanged.clear();
+		for (unsigned int index : m_order)
+		{
+			if (!m_is_changed[index])
+			{
+				m_unchanged.push_back(index);
+			}
+		}
+		std::sort(m_changed.begin(), m_changed.end(), less);
+		std::merge(m_unchanged.begin(), m_unchanged.end(), m_changed.begin(), m_changed.end(), m_order.begin(), less);
+	}
+
+	for (unsigned int rank = 0; rank < size; ++rank)
+	{
+		m_rank[m_order[rank]] = rank;
+	}
+	for (unsigned int index : m_changed)
+	{
+		m_is_changed[index] = 0;
+	}
+	m_changed.clear();
+};
@@ -0,0 +1,51 @@
+/*
+	Description:
+		Ranking keeps order of nests by fitness as permutation of indices
+		(rank -> nest and nest -> rank), nests themselves never move in population.
+		Changed nests are marked and the ranking is updated by Update():
+		changed indices are removed from order, sorted and merged with the rest,
+		so update compares O(k log k + n) pairs instead of O(n log n) for k changes.
+		Many changes (or reset) lead to full sort.
+		Ties are ordered by index of nest, so ranking is the same for full and
+		incremental update and doesn't depend on history of changes.
+*/
+
+#ifndef NEST_RANKING
+#define NEST_RANKING
+
+#include "Nest.h"
+
+#include <vector>
+#include <cstdint>
+
+class Ranking
+{
+public:
+	Ranking() {};
+
+	//Identity order, all nests are marked as changed
+	void Reset(unsigned int size);
+	void MarkChanged(unsigned int index);
+	//Restores saved order, all nests are marked as changed
+	void Assign(const std::vector<std::uint32_t>& order);
+	//Restores order after changes of fitness of marked nests
+	void Update(const double* fitness, const CompareFitness& cmp_fitness);
+
+	inline unsigned int operator[](unsigned int rank) const { return m_order[rank]; };
+	inline unsigned int GetRank(unsigned int index) const { return m_rank[index]; };
+	inline unsigned int GetBest() const { return m_order.front(); };
+	inline unsigned int GetWorst() const { return m_order.back(); };
+	inline unsigned int GetSize() const { return static_cast<unsigned int>(m_order.size()); };
+	inline bool IsActual() const { return m_changed.empty(); };
+	inline const std::vector<unsigned int>& GetOrder() const { return m_order; };
+
+private:
+	std::vector<unsigned int>	m_order;
+	std::vector<unsigned int>	m_rank;
+	std::vector<unsigned int>	m_changed;
+	std::vector<char>			m_is_changed;
+	//Buffers for merge
+	std::vector<unsigned int>	m_unchanged;
+};
+
+#endif // !NEST_RANKING
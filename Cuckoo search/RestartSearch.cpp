@@ -0,0 +1,162 @@
+#include "RestartSearch.h"
+
+#include <cmath>
+#include <thread>
+
+RestartSearch::RestartSearch(const CuckooSearch& cuckoo_search, unsigned int max_restarts, unsigned int stagnation_generations,
+	double population_growth) :
+	m_cuckoo_search(cuckoo_search), m_max_restarts(max_restarts), m_stagnation_generations(stagnation_generations),
+	m_stagnation_epsilon(0.0), m_population_growth(std::max(1.0, population_growth)), m_max_nests(0), m_total_evaluations(0),
+	m_concurrent_runs(0), m_inject_best(false), m_evaluations(0), m_has_shared_best(false), m_used_evaluations(0), m_next_run(0)
+{
+};
+
+std::valarray<double> RestartSearch::FindMin()
+{
+	return GetSolution(true);
+};
+
+std::valarray<double> RestartSearch::FindMax()
+{
+	return GetSolution(false);
+};
+
+std::valarray<double> RestartSearch::GetSolution(bool minimize)
+{
+	if (minimize)
+	{
+		m_cmp_fitness = [](double ls, double rs) {return (ls < rs); };
+	}
+	else
+	{
+		m_cmp_fitness = [](double ls, double rs) {return (ls > rs); };
+	}
+	const unsigned int runs = m_max_restarts + 1;
+	m_runs.assign(runs, RestartRun());
+	std::vector<Nest> best_nests(runs);
+	std::vector<char> is_started(runs, 0);
+	m_has_shared_best = false;
+	m_used_evaluations = 0;
+	m_next_run = 0;
+
+	const unsigned int threads = std::max(1u, std::min(runs, (m_concurrent_runs == 0) ?
+		std::thread::hardware_concurrency() : m_concurrent_runs));
+	std::shared_ptr<Executor> executor = Executor::Create(threads);
+	executor->ParallelFor(0, threads, [&](unsigned int)
+	{
+		for (unsigned int run = m_next_run++; run < runs && !IsBudgetExhausted(); run = m_next_run++)
+		{
+			is_started[run] = 1;
+			RunSearch(run, minimize, best_nests);
+		}
+	});
+
+	//Best nest is chosen in order of runs, so equal fitness of runs doesn't depend on threads
+	std::vector<RestartRun> started_runs;
+	m_evaluations = 0;
+	for (unsigned int run = 0; run < runs; ++run)
+	{
+		if (!is_started[run])
+			continue;
+		if (started_runs.empty() || m_cmp_fitness(best_nests[run].GetFitness(), m_best_ever.GetFitness()))
+		{
+			m_best_ever = best_nests[run];
+		}
+		m_evaluations += m_runs[run].evaluations;
+		started_runs.push_back(m_runs[run]);
+	}
+	m_runs = started_runs;
+	return m_best_ever.GetSolutions();
+};
+
+CuckooSearch RestartSearch::CreateRun(unsigned int run) const
+{
+	CuckooSearch cuckoo_search(m_cuckoo_search);
+	//Run 0 is the given search, restarts have bigger populations
+	if (run > 0)
+	{
+		unsigned int nests = static_cast<unsigned int>(std::lround(m_cuckoo_search.GetNumberOfNests() * std::pow(m_population_growth, run)));
+		if (m_max_nests > 0)
+		{
+			nests = std::min(nests, m_max_nests);
+		}
+		cuckoo_search.SetNumberOfNests(std::max(nests, m_cuckoo_search.GetNumberOfNests()));
+		if (m_cuckoo_search.IsFixedSeed())
+		{
+			RandomEngine seeds(m_cuckoo_search.GetSeed(), run);
+			cuckoo_search.SetSeed(seeds());
+		}
+	}
+	if (run > 0)
+	{
+		//Run 0 keeps budget of the given search, restarts stop on stagnation
+		SearchBudget budget = m_cuckoo_search.GetBudget();
+		budget.SetStagnation(m_stagnation_generations, m_stagnation_epsilon);
+		cuckoo_search.SetBudget(budget);
+	}
+	//Runs are distributed between threads, search of each run runs on its thread
+	cuckoo_search.SetNumberOfThreads(1);
+	//Copies of search share writer of one file, so runs would overwrite checkpoints of each other
+	if (m_cuckoo_search.GetCheckpointInterval() > 0)
+	{
+		cuckoo_search.SetCheckpointing(m_cuckoo_search.GetCheckpointPath() + ".run" + std::to_string(run), m_cuckoo_search.GetCheckpointInterval());
+	}
+	return cuckoo_search;
+};
+
+void RestartSearch::RunSearch(unsigned int run, bool minimize, std::vector<Nest>& best_nests)
+{
+	CuckooSearch cuckoo_search = CreateRun(run);
+	if (minimize)
+	{
+		cuckoo_search.StartMin();
+	}
+	else
+	{
+		cuckoo_search.StartMax();
+	}
+	if (run > 0 && m_inject_best)
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		if (m_has_shared_best)
+		{
+			cuckoo_search.ImportNests(SetOfNests(1, m_shared_best));
+		}
+	}
+	ShareBest(cuckoo_search.GetCurrentBestNest());
+
+	unsigned long long evaluations = cuckoo_search.GetEvaluations();
+	m_used_evaluations += evaluations;
+	while (!IsBudgetExhausted() && cuckoo_search.NextGeneration())
+	{
+		m_used_evaluations += cuckoo_search.GetEvaluations() - evaluations;
+		evaluations = cuckoo_search.GetEvaluations();
+		ShareBest(cuckoo_search.GetCurrentBestNest());
+	}
+
+	RestartRun& result = m_runs[run];
+	result.run = run;
+	result.nests = cuckoo_search.GetNumberOfNests();
+	result.seed = cuckoo_search.GetSeed();
+	result.generations = cuckoo_search.GetCurrentGeneration() - 1;
+	result.evaluations = cuckoo_search.GetEvaluations();
+	result.best_fitness = cuckoo_search.GetCurrentBestValue();
+	//Run, which is stopped by total budget, has no reason of its own
+	result.stop_reason = cuckoo_search.GetStopReason();
+	best_nests[run] = cuckoo_search.GetCurrentBestNest();
+};
+
+bool RestartSearch::IsBudgetExhausted() const
+{
+	return m_total_evaluations > 0 && m_used_evaluations >= m_total_evaluations;
+};
+
+void RestartSearch::ShareBest(const Nest& nest)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (!m_has_shared_best || m_cmp_fitness(nest.GetFitness(), m_shared_best.GetFitness()))
+	{
+		m_shared_best = nest;
+		m_has_shared_best = true;
+	}
+};
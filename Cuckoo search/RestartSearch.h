@@ -0,0 +1,97 @@
+/*
+	Description:
+		Restart strategy (IPOP) of cuckoo search. When step becomes small, population
+		stagnates and the rest of generations is wasted, so each restart stops after
+		stagnation generations without improvement (SearchBudget::SetStagnation)
+		and the next run starts with fresh population and reset step schedule.
+		Run 0 keeps budget of the given search (its own stagnation stop, if it's set).
+		Run k has nests * growth^k nests (not more than max nests), run 0 is the given search.
+		Runs are distributed between threads: while the main run (run 0) continues,
+		restarts run on spare threads, thread of finished run takes the next restart.
+		Global best is shared by runs: with best injection each restart starts with
+		global best nest in its initial population.
+		Runs of fixed seed get seeds derived from it, so without best injection and without
+		total budget result doesn't depend on number of threads (with them it depends on
+		order, in which runs finish).
+		Checkpointing of given search is kept: run k writes checkpoints to file "<path>.run<k>".
+*/
+
+#ifndef RESTART_SEARCH
+#define RESTART_SEARCH
+
+#include "CuckooSearch.h"
+#include "Executor.h"
+
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <memory>
+
+struct RestartRun
+{
+	unsigned int		run;
+	unsigned int		nests;
+	std::uint64_t		seed;
+	unsigned int		generations;
+	unsigned long long	evaluations;
+	double				best_fitness;
+	StopReason			stop_reason;
+};
+
+class RestartSearch
+{
+public:
+	RestartSearch(const CuckooSearch& cuckoo_search, unsigned int max_restarts = 8, unsigned int stagnation_generations = 100,
+		double population_growth = 2.0);
+
+	std::valarray<double> FindMin();
+	std::valarray<double> FindMax();
+
+	inline Nest GetCurrentBestNest() const { return m_best_ever; };
+	inline double GetCurrentBestValue() const { return m_best_ever.GetFitness(); };
+	//Runs in order of their numbers (runs, which weren't started, are absent)
+	inline const std::vector<RestartRun>& GetRuns() const { return m_runs; };
+	//Evaluations of all runs
+	inline unsigned long long GetEvaluations() const { return m_evaluations; };
+
+	inline void SetMaxRestarts(unsigned int restarts) { m_max_restarts = restarts; };
+	inline void SetStagnation(unsigned int generations, double epsilon = 0.0) { m_stagnation_generations = generations; m_stagnation_epsilon = epsilon; };
+	inline void SetPopulationGrowth(double growth) { m_population_growth = std::max(1.0, growth); };
+	//max_nests = 0 - without limit
+	inline void SetMaxNests(unsigned int nests) { m_max_nests = nests; };
+	//Runs don't start and running runs stop, when all runs used evaluations (0 - without limit)
+	inline void SetTotalEvaluations(unsigned long long evaluations) { m_total_evaluations = evaluations; };
+	//threads = 0 - run for each hardware thread
+	inline void SetConcurrentRuns(unsigned int runs) { m_concurrent_runs = runs; };
+	inline void InjectBest(bool inject) { m_inject_best = inject; };
+
+protected:
+	CuckooSearch				m_cuckoo_search;
+	unsigned int				m_max_restarts;
+	unsigned int				m_stagnation_generations;
+	double						m_stagnation_epsilon;
+	double						m_population_growth;
+	unsigned int				m_max_nests;
+	unsigned long long			m_total_evaluations;
+	unsigned int				m_concurrent_runs;
+	bool						m_inject_best;
+	std::vector<RestartRun>		m_runs;
+	Nest						m_best_ever;
+	CompareFitness				m_cmp_fitness;
+	unsigned long long			m_evaluations;
+
+	//Shared state of running search
+	std::mutex					m_mutex;
+	Nest						m_shared_best;
+	bool						m_has_shared_best;
+	std::atomic<unsigned long long>	m_used_evaluations;
+	std::atomic<unsigned int>	m_next_run;
+
+	std::valarray<double> GetSolution(bool minimize);
+	CuckooSearch CreateRun(unsigned int run) const;
+	void RunSearch(unsigned int run, bool minimize, std::vector<Nest>& best_nests);
+	bool IsBudgetExhausted() const;
+	void ShareBest(const Nest& nest);
+};
+
+#endif // !RESTART_SEARCH
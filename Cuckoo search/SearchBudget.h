@@ -0,0 +1,76 @@
+/*
+	Description:
+		Budget of search: limits, which stop search (besides maximum number of generations
+		and stop criterian): maximum number of objective evaluations, wall-clock deadline,
+		target fitness and stagnation (best ever fitness isn't improved by more than
+		epsilon during N generations). Zero limit means no limit.
+		Budget also defines progress of search - the biggest consumed part of
+		generations, evaluations and time, progress drives decay of step.
+*/
+
+#ifndef SEARCH_BUDGET
+#define SEARCH_BUDGET
+
+enum class StopReason
+{
+	NONE,
+	MAX_GENERATIONS,
+	MAX_EVALUATIONS,
+	DEADLINE,
+	TARGET_FITNESS,
+	STAGNATION,
+	STOP_CRITERIAN
+};
+
+class SearchBudget
+{
+public:
+	SearchBudget() :
+		m_max_evaluations(0), m_max_seconds(0.0), m_use_target_fitness(false), m_target_fitness(0.0),
+		m_stagnation_generations(0), m_stagnation_epsilon(0.0) {};
+
+	inline void SetMaxEvaluations(unsigned long long evaluations) { m_max_evaluations = evaluations; };
+	inline void SetDeadline(double seconds) { m_max_seconds = seconds; };
+	//Search stops, when best fitness is equal or better than target
+	inline void SetTargetFitness(double fitness) { m_target_fitness = fitness; m_use_target_fitness = true; };
+	inline void ClearTargetFitness() { m_use_target_fitness = false; };
+	inline void SetStagnation(unsigned int generations, double epsilon = 0.0) { m_stagnation_generations = generations; m_stagnation_epsilon = epsilon; };
+
+	inline unsigned long long GetMaxEvaluations() const { return m_max_evaluations; };
+	inline double GetDeadline() const { return m_max_seconds; };
+	inline bool UseTargetFitness() const { return m_use_target_fitness; };
+	inline double GetTargetFitness() const { return m_target_fitness; };
+	inline unsigned int GetStagnationGenerations() const { return m_stagnation_generations; };
+	inline double GetStagnationEpsilon() const { return m_stagnation_epsilon; };
+
+private:
+	unsigned long long	m_max_evaluations;
+	double				m_max_seconds;
+	bool				m_use_target_fitness;
+	double				m_target_fitness;
+	unsigned int		m_stagnation_generations;
+	double				m_stagnation_epsilon;
+};
+
+inline const char* GetStopReasonName(StopReason reason)
+{
+	switch (reason)
+	{
+	case StopReason::MAX_GENERATIONS:
+		return "max generations";
+	case StopReason::MAX_EVALUATIONS:
+		return "max evaluations";
+	case StopReason::DEADLINE:
+		return "deadline";
+	case StopReason::TARGET_FITNESS:
+		return "target fitness";
+	case StopReason::STAGNATION:
+		return "stagnation";
+	case StopReason::STOP_CRITERIAN:
+		return "stop criterian";
+	default:
+		return "none";
+	}
+};
+
+#endif // !SEARCH_BUDGET
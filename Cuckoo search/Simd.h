@@ -0,0 +1,62 @@
+/*
+	Description:
+		Helpers for loops, which have to be vectorized by compiler.
+		CUCKOO_SIMD_LOOP is placed before loop without dependencies between iterations.
+		AlignedAllocator gives memory aligned on cache line, so rows of
+		matrices can start on vector boundary.
+*/
+
+#ifndef SIMD_HELPER
+#define SIMD_HELPER
+
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CUCKOO_SIMD_LOOP __pragma(loop(ivdep))
+#elif defined(__clang__)
+#define CUCKOO_SIMD_LOOP _Pragma("clang loop vectorize(enable)")
+#elif defined(__GNUC__)
+#define CUCKOO_SIMD_LOOP _Pragma("GCC ivdep")
+#else
+#define CUCKOO_SIMD_LOOP
+#endif
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+#include <vector>
+
+const std::size_t CACHE_LINE_SIZE = 64;
+
+template <typename T, std::size_t Alignment = CACHE_LINE_SIZE>
+class AlignedAllocator
+{
+public:
+	using value_type = T;
+	template <typename U> struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+	AlignedAllocator() {};
+	template <typename U> AlignedAllocator(const AlignedAllocator<U, Alignment>&) {};
+
+	T* allocate(std::size_t size)
+	{
+		//Address of original block is saved just before aligned block
+		void* memory = ::operator new(size * sizeof(T) + Alignment + sizeof(void*));
+		std::uintptr_t address = reinterpret_cast<std::uintptr_t>(memory) + sizeof(void*);
+		address = (address + Alignment - 1) & ~std::uintptr_t(Alignment - 1);
+		reinterpret_cast<void**>(address)[-1] = memory;
+		return reinterpret_cast<T*>(address);
+	};
+
+	void deallocate(T* pointer, std::size_t)
+	{
+		::operator delete(reinterpret_cast<void**>(pointer)[-1]);
+	};
+};
+
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return true; };
+template <typename T, typename U, std::size_t Alignment>
+inline bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) { return false; };
+
+using AlignedVector = std::vector<double, AlignedAllocator<double>>;
+
+#endif // !SIMD_HELPER
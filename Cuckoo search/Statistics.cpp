@@ -10,6 +10,8 @@ Statistics::Statistics(CuckooSearch& cs) :
 	m_info.cuckoo_info.step = m_cs.GetStep();
 	m_info.cuckoo_info.probability = m_cs.GetAbandonProbability();
 	m_basic_test = true;
+	m_trace_test = 0;
+	m_reservoir_size = 0;
 };
 
 void Statistics::RunTestMin(unsigned int number_of_tests)
@@ -35,11 +37,12 @@ void Statistics::RunTestMin(unsigned int number_of_tests)
 	m_info.number_of_tests = number_of_tests;
 	m_info.result_statistics.all_results = std::valarray<double>(number_of_tests);
 	m_info.solutions = std::vector<Nest>(number_of_tests);
+	m_info.profile.Reset();
 
 	PrintHeader(std::cout);
 	PrintHeader(o_file);
 
-	std::clock_t start_time = std::clock();
+	const auto start_time = std::chrono::steady_clock::now();
 	o_file.close();
 
 	for (m_curr_test = 0; m_curr_test < number_of_tests; ++m_curr_test)
@@ -48,6 +51,7 @@ void Statistics::RunTestMin(unsigned int number_of_tests)
 		m_cs.FindMin();
 		m_info.solutions[m_curr_test] = m_cs.GetCurrentBestNest();
 		m_info.result_statistics.all_results[m_curr_test] = m_cs.GetCurrentBestValue();
+		m_info.profile.Merge(m_cs.GetProfile());
 		std::cout << m_info.result_statistics.all_results[m_curr_test] << "\n";
 
 		std::ofstream o_file(full_file_path, std::ios_base::app);
@@ -55,7 +59,7 @@ void Statistics::RunTestMin(unsigned int number_of_tests)
 		o_file.close();
 	}
 
-	m_info.test_time = std::clock() - start_time;
+	m_info.test_time = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
 	CalculateResultStatistics();
 	o_file = std::ofstream(full_file_path, std::ios_base::app);
 	OutputTotalInfo(std::cout);
@@ -66,11 +70,12 @@ void Statistics::RunAnvancedTestMin(unsigned int number_of_tests)
 {
 	m_basic_test = false;
 	m_info.number_of_tests = number_of_tests;
-	CreateStructs();
+	m_convergence.Reset(m_info.cuckoo_info.iterations, m_cs.GetObjectiveFunction().GetNumberOfDimensions(), m_points, number_of_tests);
+	m_reservoir = TraceReservoir(m_reservoir_size, RandomEngine::GetRandomSeed());
 	CreateHandler();
 	m_cs.SetStatisticsHandler(&m_handler);
 	Statistics::RunTestMin(number_of_tests);
-	CalculateSolutionStatistics();
+	FinishTrace();
 	std::cout << "Printing log...\n";
 	PrintDynamics();
 	PrintLog();
@@ -99,39 +104,25 @@ void Statistics::CalculateResultStatistics()
 	m_info.result_statistics.std_dev = GetStdDeviation();
 };
 
-void Statistics::CalculateSolutionStatistics()
-{
-	unsigned int number_of_tests = static_cast<unsigned int>(m_info.result_statistics.all_results.size());
-	m_info.solution_statistics.average_fitness_dynamics = m_info.solution_statistics.fitness_dynamics.sum() / double(number_of_tests);
-	m_info.solution_statistics.average_solution_dynamics = m_info.solution_statistics.solution_dynamics.sum() /
-		std::valarray<double>(double(number_of_tests), m_info.cuckoo_info.iterations);
-};
-
-void Statistics::CreateStructs()
-{
-	m_info.solution_statistics.average_fitness_dynamics = std::valarray<double>(0.0, m_points);
-	m_info.solution_statistics.average_solution_dynamics = std::valarray<std::valarray<double>>(
-		std::valarray<double>(0.0, m_cs.GetObjectiveFunction().GetNumberOfDimensions()), m_info.cuckoo_info.iterations);
-	m_info.solution_statistics.fitness_dynamics = std::valarray<std::valarray<double>>(
-		std::valarray<double>(0.0, m_info.cuckoo_info.iterations), m_info.number_of_tests);
-	m_info.solution_statistics.solution_dynamics = std::valarray<std::valarray<Egg>>(std::valarray<Egg>(
-		std::valarray<double>(0.0, m_cs.GetObjectiveFunction().GetNumberOfDimensions()), m_info.cuckoo_info.iterations), m_info.number_of_tests);
-};
-
 void Statistics::OutputTotalInfo(std::ostream& o_stream, bool print_solutions)
 {
-	o_stream << "\t" << "Test time: " << m_info.test_time / double(CLOCKS_PER_SEC) << " seconds\n";
-	o_stream << "\t" << "Avarage time for each function: " << m_info.test_time / (CLOCKS_PER_SEC * double(m_info.result_statistics.all_results.size())) << "\n";
+	o_stream << "\t" << "Test time: " << m_info.test_time << " seconds\n";
+	o_stream << "\t" << "Avarage time for each function: " << m_info.test_time / double(m_info.result_statistics.all_results.size()) << "\n";
 	o_stream << "\t" << "Worst result: " << m_info.result_statistics.worst_result << "\n";
 	o_stream << "\t" << "Best result: " << m_info.result_statistics.best_result << "\n";
 	o_stream << "\t" << "Average result: " << m_info.result_statistics.average_result << "\n";
 	o_stream << "\t" << "Standard deviation: " << m_info.result_statistics.std_dev << "\n";
+	if (PROFILING_ENABLED)
+	{
+		o_stream << "\t*** PROFILE ***" << "\n";
+		o_stream << m_info.profile;
+	}
 	o_stream << "\t\t" << "*********************\n\n";
 
 	if (print_solutions)
 	{
 		o_stream << "\t*** SOLUTIONS ***" << "\n";
-		for (int i = 0; i < m_info.solutions.size(); ++i)
+		for (size_t i = 0; i < m_info.solutions.size(); ++i)
 		{
 			o_stream << "\tTest#" << (i + 1) << ": ";
 			o_stream << m_info.solutions[i] << "\n";
@@ -155,54 +146,15 @@ void Statistics::PrintLog()
 {
 	if (m_log_files)
 	{
-		std::string file_path = m_solutions_log_path + m_info.function_name + "\\";
-		bool is_lazy = m_cs.IsLazyCuckoo();
-
-		for (unsigned int i = 0; i < m_info.number_of_tests; ++i)
+		//Traces are read one by one
+		const std::string suffix = m_cs.IsLazyCuckoo() ? "ModTestLog.txt" : "TestLog.txt";
+		for (unsigned int test : m_reservoir.GetTests())
 		{
-			std::string full_file_path = file_path + "#" + std::to_string(i + 1);
-			if (is_lazy)
-			{
-				full_file_path += "ModTestLog.txt";
-			}
-			else
-			{
-				full_file_path += "TestLog.txt";
-			}
-			std::ofstream o_file(full_file_path);
-			for (unsigned int j = 0; j < m_info.cuckoo_info.iterations; ++j)
-			{
-				o_file << std::fixed;
-				o_file << "#" << (j + 1) << " : Function value: " << std::setprecision(14) << m_info.solution_statistics.fitness_dynamics[i][j];
-				for (unsigned int k = 0; k < m_cs.GetObjectiveFunction().GetNumberOfDimensions(); ++k)
-				{
-					o_file << std::setprecision(5) << m_info.solution_statistics.solution_dynamics[i][j][k] << ", ";
-				}
-				o_file << m_info.solution_statistics.solution_dynamics[i][j][m_cs.GetObjectiveFunction().GetNumberOfDimensions() - 1] << "]\n";
-			}
-			o_file.close();
+			std::ofstream o_file(GetLogPath(m_solutions_log_path, std::to_string(test + 1)) + suffix);
+			ExportTextLog(ReadTrace(GetTracePath(test)), o_file);
 		}
-		std::string full_file_path = file_path + "#AVERAGE_";
-		if (is_lazy)
-		{
-			full_file_path += "ModTestLog.txt";
-		}
-		else
-		{
-			full_file_path += "TestLog.txt";
-		}
-		std::ofstream o_file(full_file_path);
-		for (unsigned int i = 0; i < m_info.cuckoo_info.iterations; ++i)
-		{
-			o_file << std::fixed;
-			o_file << "#" << (i + 1) << " : Function value: " << std::setprecision(14) << m_info.solution_statistics.average_fitness_dynamics[i];
-			for (unsigned int j = 0; j < m_cs.GetObjectiveFunction().GetNumberOfDimensions(); ++j)
-			{
-				o_file << std::setprecision(5) << m_info.solution_statistics.average_solution_dynamics[i][j] << ", ";
-			}
-			o_file << m_info.solution_statistics.average_solution_dynamics[i][m_cs.GetObjectiveFunction().GetNumberOfDimensions() - 1] << "]\n";
-		}
-		o_file.close();
+		std::ofstream o_file(GetLogPath(m_solutions_log_path, "AVERAGE_") + suffix);
+		ExportTextLog(m_convergence.GetAverageTrace(CreateTraceHeader()), o_file);
 	}
 };
 
@@ -210,58 +162,78 @@ void Statistics::PrintDynamics()
 {
 	if (m_grapher_files)
 	{
-		std::string file_path = m_grapher_files_path + m_info.function_name + "\\";
-		bool is_lazy = m_cs.IsLazyCuckoo();
+		const std::string suffix = m_cs.IsLazyCuckoo() ? "ModTestGraphLog.txt" : "TestGraphLog.txt";
+		const TraceHeader header = CreateTraceHeader();
 		for (unsigned int i = 0; i < m_info.number_of_tests; ++i)
 		{
-			std::string full_file_path = file_path + "#" + std::to_string(i + 1);
-			if (is_lazy)
-			{
-				full_file_path += "ModTestGraphLog.txt";
-			}
-			else
-			{
-				full_file_path += "TestGraphLog.txt";
-			}
-			std::ofstream o_file(full_file_path);
-			const unsigned int step = m_info.cuckoo_info.iterations / m_points;
-			int j = 0;
-			while (j * step < m_info.cuckoo_info.iterations)
-			{
-				o_file << (j * step) << " " << m_info.solution_statistics.fitness_dynamics[i][j * step] << "\n";
-				++j;
-			}
-			o_file.close();
-		}
-		std::string full_file_path = file_path + "#AVERAGE_";
-		if (is_lazy)
-		{
-			full_file_path += "ModTestGraphLog.txt";
-		}
-		else
-		{
-			full_file_path += "TestGraphLog.txt";
-		}
-		std::ofstream o_file(full_file_path);
-		const unsigned int step = m_info.cuckoo_info.iterations / m_points;
-		int i = 0;
-		while (i * step < m_info.cuckoo_info.iterations)
-		{
-			o_file << (i * step) << " " << m_info.solution_statistics.average_fitness_dynamics[i * step] << "\n";
-			++i;
+			std::ofstream o_file(GetLogPath(m_grapher_files_path, std::to_string(i + 1)) + suffix);
+			ExportGrapherLog(m_convergence.GetCheckpointTrace(header, i), o_file, m_points);
 		}
-		o_file.close();
+		std::ofstream o_file(GetLogPath(m_grapher_files_path, "AVERAGE_") + suffix);
+		ExportGrapherLog(m_convergence.GetAverageTrace(header), o_file, m_points);
+		std::ofstream deviation_file(GetLogPath(m_grapher_files_path, "STD_DEV_") + suffix);
+		ExportGrapherLog(m_convergence.GetDeviationTrace(header), deviation_file, m_points);
+	}
+};
+
+std::string Statistics::GetLogPath(const std::string& directory, const std::string& test_name) const
+{
+	return directory + m_info.function_name + "/" + "#" + test_name;
+};
+
+std::string Statistics::GetTracePath(unsigned int test) const
+{
+	return GetLogPath(m_solutions_log_path, std::to_string(test + 1)) + (m_cs.IsLazyCuckoo() ? "ModTestLog.trace" : "TestLog.trace");
+};
+
+TraceHeader Statistics::CreateTraceHeader() const
+{
+	TraceHeader header;
+	header.function_name = m_info.function_name;
+	header.dimensions = m_cs.GetObjectiveFunction().GetNumberOfDimensions();
+	header.nests = m_info.cuckoo_info.nests;
+	header.iterations = m_info.cuckoo_info.iterations;
+	header.min_lambda = m_info.cuckoo_info.lambda.GetMinLambda();
+	header.max_lambda = m_info.cuckoo_info.lambda.GetMaxLamda();
+	header.min_step = m_info.cuckoo_info.step.GetMinStep()[0];
+	header.max_step = m_info.cuckoo_info.step.GetMaxStep()[0];
+	header.probability = m_info.cuckoo_info.probability;
+	header.lazy_cuckoo = m_cs.IsLazyCuckoo();
+	header.seed = m_cs.GetSeed();
+	header.test = m_curr_test + 1;
+	header.compression = TraceCompression::DELTA;
+	return header;
+};
+
+void Statistics::FinishTrace()
+{
+	if (!m_trace_writer)
+		return;
+	m_trace_writer.reset();
+	const int dropped = m_reservoir.Offer(m_trace_test);
+	if (dropped >= 0)
+	{
+		std::remove(GetTracePath(dropped).c_str());
 	}
 };
 
 void Statistics::CreateHandler()
 {
+	m_trace_writer.reset();
 	m_handler =
 	[&]() 
 	{
-		const unsigned int curr_generation = m_cs.GetCurrentGeneration() - 1;
-		m_info.solution_statistics.fitness_dynamics[m_curr_test][curr_generation] = m_cs.GetCurrentBestNest().GetFitness();
-		m_info.solution_statistics.solution_dynamics[m_curr_test][curr_generation] = m_cs.GetCurrentBestNest().GetSolutions();
+		//Each test has own trace, trace is written during the run
+		if (!m_trace_writer || m_trace_test != m_curr_test)
+		{
+			FinishTrace();
+			m_trace_writer.reset(new TraceWriter(GetTracePath(m_curr_test), CreateTraceHeader()));
+			m_trace_test = m_curr_test;
+		}
+		const Nest& best = m_cs.GetCurrentBestNest();
+		const unsigned int generation = m_cs.GetCurrentGeneration() - 1;
+		m_trace_writer->Append(generation, best.GetFitness(), &best.GetSolutionsRef()[0]);
+		m_convergence.Add(m_curr_test, generation, best.GetFitness(), &best.GetSolutionsRef()[0]);
 	};
 };
 
@@ -269,7 +241,7 @@ void Compare::RunTestMin(unsigned int number_of_tests)
 {
 	m_cs.UseLazyCuckoo();
 	Statistics::RunTestMin(number_of_tests);
-	m_cs.SetMaxGenerations(unsigned int(m_cs.GetMaxGenerations() * m_multiplier));
+	m_cs.SetMaxGenerations(static_cast<unsigned int>(m_cs.GetMaxGenerations() * m_multiplier));
 	m_cs.UseStandartCuckoo();
 	m_info.cuckoo_info.iterations = m_cs.GetMaxGenerations();
 	Statistics::RunTestMin(number_of_tests);
@@ -279,7 +251,7 @@ void Compare::RunAnvancedTestMin(unsigned int number_of_tests)
 {
 	m_cs.UseLazyCuckoo();
 	Statistics::RunAnvancedTestMin(number_of_tests);
-	m_cs.SetMaxGenerations(unsigned int(m_cs.GetMaxGenerations() * m_multiplier));
+	m_cs.SetMaxGenerations(static_cast<unsigned int>(m_cs.GetMaxGenerations() * m_multiplier));
 	m_cs.UseStandartCuckoo();
 	m_info.cuckoo_info.iterations = m_cs.GetMaxGenerations();
 	Statistics::RunAnvancedTestMin(number_of_tests);
@@ -2,6 +2,12 @@
 	Description:
 		Class for tests automatization and collects statistics 
 		which is saved in file and printed in console.
+		Advanced test writes binary convergence trace of each test during the run
+		(logs\<function>\#<test>TestLog.trace) and accumulates online statistics of
+		convergence, so memory doesn't depend on number of tests.
+		Text logs are exported from traces, average log and files for 4AdvancedGrapher
+		are exported from online statistics, if they are enabled.
+		KeepTraces(n) keeps traces only of n random tests (reservoir sampling).
 */
 
 #ifndef STATISTICS
@@ -9,13 +15,17 @@
 
 #include "CuckooSearch.h"
 #include "FunctionHelper.h"
+#include "ConvergenceTrace.h"
+#include "OnlineStatistics.h"
 
 #include <string>
 #include <vector>
 #include <iostream>
 #include <fstream>
-#include <ctime>
+#include <chrono>
+#include <cstdio>
 #include <algorithm>
+#include <memory>
 
 
 struct CuckooInfo
@@ -36,15 +46,6 @@ struct ResultStatistics
 	double std_dev;
 };
 
-struct SolutionStatistics
-{
-	std::valarray<std::valarray<double>> fitness_dynamics;
-	std::valarray<double> average_fitness_dynamics;
-
-	std::valarray<std::valarray<Egg>> solution_dynamics;
-	std::valarray<Egg> average_solution_dynamics;
-};
-
 struct TestInfo
 {
 	std::string function_name;
@@ -52,8 +53,10 @@ struct TestInfo
 	CuckooInfo	cuckoo_info;
 	ResultStatistics result_statistics;
 	std::vector<Nest> solutions;
-	SolutionStatistics solution_statistics;
-	std::clock_t test_time;
+	//Sum of profiles of tests (with CUCKOO_PROFILING)
+	ProfileData profile;
+	//Wall time in seconds
+	double test_time;
 };
 
 class Statistics
@@ -66,29 +69,39 @@ public:
 	virtual void RunAnvancedTestMin(unsigned int number_of_tests = 1);
 	void CreateFiles4Grapher(bool create, unsigned int points_4_function = 50);
 	inline void CreateSolutionsLog(bool create) { m_log_files = create; };
+	//tests = 0 - traces of all tests are kept
+	inline void KeepTraces(unsigned int tests) { m_reservoir_size = tests; };
+	inline const ConvergenceStatistics& GetConvergenceStatistics() const { return m_convergence; };
 protected:
 	CuckooSearch m_cs;
 	TestInfo m_info;
 	StatisticsHandler m_handler;
-	std::string m_functions_tests_path = "Function test\\";
-	std::string m_solutions_log_path = "logs\\";
-	std::string m_grapher_files_path = "4AdvancedGrapher\\";
+	std::string m_functions_tests_path = "Function test/";
+	std::string m_solutions_log_path = "logs/";
+	std::string m_grapher_files_path = "4AdvancedGrapher/";
 
 	bool m_grapher_files;
 	unsigned int m_points;
 	bool m_log_files;
 	unsigned int m_curr_test;
 	bool m_basic_test;
+	std::unique_ptr<TraceWriter> m_trace_writer;
+	unsigned int m_trace_test;
+	ConvergenceStatistics m_convergence;
+	TraceReservoir m_reservoir;
+	unsigned int m_reservoir_size;
 
 	double GetStdDeviation();
 	void CalculateResultStatistics();
-	void CalculateSolutionStatistics();
-	void CreateStructs();
 
 	void OutputTotalInfo(std::ostream& o_stream, bool print_solutions = false);
 	void PrintHeader(std::ostream& o_stream);
 	void PrintLog();
 	void PrintDynamics();
+	std::string GetLogPath(const std::string& directory, const std::string& test_name) const;
+	std::string GetTracePath(unsigned int test) const;
+	TraceHeader CreateTraceHeader() const;
+	void FinishTrace();
 
 	void CreateHandler();
 };
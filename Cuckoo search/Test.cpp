@@ -7,8 +7,18 @@
 #include "CuckooSearch.h"
 #include "TestFunctions.h"
 #include "Statistics.h"
+#include "IslandSearch.h"
+#include "RestartSearch.h"
+#include "TrialHarness.h"
+#include "AllocationCounter.h"
+#include "ExperimentRunner.h"
+#include "ParameterTuner.h"
 
 #include <stdlib.h>
+#include <iostream>
+#include <string>
+#include <map>
+#include <sstream>
 
 enum enum_functions
 {
@@ -39,6 +49,16 @@ const bool COMPARE_METHODS = false;
 //Iteration multiplier for second algorithm (modified Cuckoo needs 3 times more calling objective function).
 //This parameter enable just if set Compare methods in true.
 const double ITER_MULTIPLIER = 3.0;
+//Budget of objective evaluations for each test (0 - no budget). With budget compared methods
+//get the same number of evaluations, ITER_MULTIPLIER just limits generations.
+const unsigned long long MAX_EVALUATIONS = 0;
+//Running test writes checkpoint after each CHECKPOINT_INTERVAL generations (0 - no checkpoints),
+//interrupted test can be continued by CuckooSearch::Resume
+const unsigned int CHECKPOINT_INTERVAL = 0;
+//Flights change only SUBSPACE_BLOCKS random blocks of SUBSPACE_BLOCK_SIZE coordinates
+//(0 - all coordinates), it's useful for functions with thousands of dimensions
+const unsigned int SUBSPACE_BLOCK_SIZE = 0;
+const unsigned int SUBSPACE_BLOCKS = 1;
 //Advanced test create handler, which can doing algorithm more slower, 
 //but It handle more information and can create logs
 const bool ADVANCED_TEST = false;
@@ -48,9 +68,160 @@ const bool CREATE_LOG = true;
 //demonstrates dynamics of objective function value changes
 const bool CREATE_4_GRAPHER = true;
 const unsigned int POINTS = 50;
+//Benchmark harness runs independent trials concurrently and writes CSV and JSON results
+//into "Function test" directory (CONCURRENT_TRIALS = 0 - trial for each hardware thread)
+const bool BENCHMARK_HARNESS = false;
+const unsigned int CONCURRENT_TRIALS = 0;
+const std::uint64_t BASE_SEED = 1;
+//Allocation test counts heap allocations of generations after warm-up
+//(program has to be built with CUCKOO_COUNT_ALLOCATIONS)
+const bool ALLOCATION_TEST = false;
+const unsigned int WARMUP_GENERATIONS = 10;
+//Island model: populations are searched independently and exchange best nests
+const bool ISLAND_MODEL = false;
+const unsigned int ISLANDS = 4;
+const unsigned int MIGRATION_INTERVAL = 50;
+const unsigned int MIGRATION_SIZE = 2;
+const MigrationTopology TOPOLOGY = MigrationTopology::RING;
+//Restarts (IPOP): restart stops after RESTART_STAGNATION generations without improvement and next run
+//starts with POPULATION_GROWTH times more nests, restarts run concurrently on spare threads
+const bool RESTART_MODEL = false;
+const unsigned int MAX_RESTARTS = 8;
+const unsigned int RESTART_STAGNATION = 100;
+const double POPULATION_GROWTH = 2.0;
+//Constrained test: the same function with linear constraint sum(x) >= 1, objective is
+//evaluated only for feasible points (feasibility rule), flights are projected onto constraint
+const bool CONSTRAINED_TEST = false;
+//Prefix of sockets for islands in different processes (program --island <rank> <size>)
+const std::string ISLAND_SOCKET_PREFIX = "/tmp/cuckoo_island_";
+
+//Set by command line: this process is one island of several processes
+std::shared_ptr<MigrationTransport> island_transport;
+
+void run_island_tests(CuckooSearch& cs)
+{
+	IslandSearch islands(cs, ISLANDS, MIGRATION_INTERVAL, MIGRATION_SIZE, TOPOLOGY);
+	islands.SetTransport(island_transport);
+	for (unsigned int i = 0; i < NUMBER_OF_TESTS; ++i)
+	{
+		islands.FindMin();
+		std::cout << "Island test " << i + 1 << ": best value = " << islands.GetCurrentBestValue() << "\n";
+	}
+};
+
+void run_restart_tests(CuckooSearch& cs)
+{
+	RestartSearch restarts(cs, MAX_RESTARTS, RESTART_STAGNATION, POPULATION_GROWTH);
+	for (unsigned int i = 0; i < NUMBER_OF_TESTS; ++i)
+	{
+		restarts.FindMin();
+		std::cout << "Restart test " << i + 1 << ": best value = " << restarts.GetCurrentBestValue() << " (" <<
+			restarts.GetRuns().size() << " runs, " << restarts.GetEvaluations() << " evaluations)\n";
+	}
+};
+
+void run_constrained_tests(CuckooSearch& cs)
+{
+	const unsigned int dimensions = cs.GetObjectiveFunction().GetNumberOfDimensions();
+	std::shared_ptr<ConstraintSet> constraints = std::make_shared<ConstraintSet>(ConstraintHandling::FEASIBILITY_RULE);
+	constraints->AddLinearInequality(std::vector<double>(dimensions, -1.0), -1.0);
+	cs.SetConstraints(constraints);
+	for (unsigned int i = 0; i < NUMBER_OF_TESTS; ++i)
+	{
+		const Egg solution = cs.FindMin();
+		std::cout << "Constrained test " << i + 1 << ": best value = " << cs.GetCurrentBestValue() << ", violation = " <<
+			constraints->GetViolation(&solution[0], dimensions) << "\n";
+	}
+	cs.SetConstraints(nullptr);
+};
+
+void run_allocation_test(CuckooSearch& cs)
+{
+	if (!AllocationCounter::IsEnabled())
+	{
+		std::cout << "Allocation test: program is built without CUCKOO_COUNT_ALLOCATIONS\n";
+		return;
+	}
+	cs.StartMin();
+	for (unsigned int i = 0; i < WARMUP_GENERATIONS; ++i)
+	{
+		cs.NextGeneration();
+	}
+	unsigned long long allocations = AllocationCounter::GetAllocations();
+	unsigned long long bytes = AllocationCounter::GetAllocatedBytes();
+	unsigned int generations = 0;
+	while (cs.NextGeneration())
+	{
+		++generations;
+	}
+	allocations = AllocationCounter::GetAllocations() - allocations;
+	bytes = AllocationCounter::GetAllocatedBytes() - bytes;
+	std::cout << cs.GetObjectiveFunction().GetName() << ": " << generations << " generations, " <<
+		allocations << " allocations (" << bytes << " bytes)\n";
+};
+
+void run_harness(CuckooSearch& cs)
+{
+	TrialHarness harness(cs, NUMBER_OF_TESTS, BASE_SEED);
+	harness.SetConcurrentTrials(CONCURRENT_TRIALS);
+	harness.RunMin();
+	for (const TrialResult& result : harness.GetResults())
+	{
+		std::cout << "Trial #" << result.trial + 1 << " result: " << result.best_fitness << " (" << result.wall_seconds << " s, " <<
+			result.evaluations_per_second << " evaluations/s)\n";
+	}
+	std::cout << "Total time: " << harness.GetTotalWallTime() << " seconds\n";
+
+	const std::string file_path = "Function test/" + cs.GetObjectiveFunction().GetName() + (cs.IsLazyCuckoo() ? "_mod_trials" : "_std_trials");
+	std::ofstream csv_file(file_path + ".csv");
+	harness.WriteCsv(csv_file);
+	std::ofstream json_file(file_path + ".json");
+	harness.WriteJson(json_file);
+};
 
 void run_tests(CuckooSearch& cs)
 {
+	if (MAX_EVALUATIONS > 0)
+	{
+		SearchBudget budget;
+		budget.SetMaxEvaluations(MAX_EVALUATIONS);
+		cs.SetBudget(budget);
+	}
+	if (SUBSPACE_BLOCK_SIZE > 0)
+	{
+		cs.SetSubspaceFlights(SUBSPACE_BLOCK_SIZE, SUBSPACE_BLOCKS);
+	}
+	if (CHECKPOINT_INTERVAL > 0)
+	{
+		cs.SetCheckpointing("Function test/" + cs.GetObjectiveFunction().GetName() + ".checkpoint", CHECKPOINT_INTERVAL);
+	}
+	if (ALLOCATION_TEST)
+	{
+		run_allocation_test(cs);
+		return;
+	}
+	if (BENCHMARK_HARNESS)
+	{
+		run_harness(cs);
+		return;
+	}
+
+	if (ISLAND_MODEL || island_transport)
+	{
+		run_island_tests(cs);
+		return;
+	}
+	if (CONSTRAINED_TEST)
+	{
+		run_constrained_tests(cs);
+		return;
+	}
+	if (RESTART_MODEL)
+	{
+		run_restart_tests(cs);
+		return;
+	}
+
 	Statistics* stat;
 	if (COMPARE_METHODS)
 	{
@@ -203,12 +374,98 @@ void test()
 		}
 	}
 
-	system("pause");
+#ifdef _WIN32
+	//Console window of Visual Studio is closed after exit
+	if (!island_transport)
+	{
+		system("pause");
+	}
+#endif
+};
+
+
+//Functions, which can be chosen by name from command line
+std::map<std::string, ObjectiveFunction> get_named_functions()
+{
+	return { { "sphere", sphere_function }, { "ackley", ackley_function }, { "griewank", griewank_function },
+		{ "rosenbrock", rosenbrock_function }, { "rastrigin", rastrigin_function }, { "michaelwicz", michaelwicz_function } };
+};
+
+//Runs grid of experiment file (see ExperimentRunner.h) instead of constants above
+int run_experiment(const std::string& file_path)
+{
+	ExperimentRunner runner;
+	for (const auto& function : get_named_functions())
+	{
+		runner.RegisterFunction(function.first, function.second);
+	}
+	try
+	{
+		runner.Load(file_path);
+		runner.Run();
+	}
+	catch (std::exception& e)
+	{
+		std::cout << e.what();
+		return EXIT_FAILURE;
+	}
+	runner.WriteResults(std::cout);
+	return EXIT_SUCCESS;
 };
 
+//Tunes step, lambda and abandon probability of search with parameters above for each function
+int run_tuning(unsigned long long evaluations, const std::vector<std::string>& function_names)
+{
+	const std::map<std::string, ObjectiveFunction> functions = get_named_functions();
+	std::ostringstream tuned_parameters;
+	for (const std::string& name : function_names)
+	{
+		const auto function = functions.find(name);
+		if (function == functions.end())
+		{
+			std::cout << "Unknown function " << name << "\n";
+			return EXIT_FAILURE;
+		}
+		CuckooSearch cs = CuckooSearch(function->second, AMOUNT_OF_NESTS, { MIN_STEP, MAX_STEP },
+			{ MIN_LAMBDA, MAX_LAMBDA }, ABANDON_PROBABILITY, ITERATIONS);
+		if (USE_LAZY_CUCKOO)
+		{
+			cs.UseLazyCuckoo();
+		}
+		ParameterTuner tuner(cs, evaluations);
+		try
+		{
+			tuner.TuneMin();
+		}
+		catch (std::exception& e)
+		{
+			std::cout << e.what();
+			return EXIT_FAILURE;
+		}
+		tuner.WriteResult(std::cout);
+		std::cout << "\n";
+		tuner.WriteParameters(tuned_parameters, name);
+	}
+	//Parameter sets for experiment file
+	std::cout << tuned_parameters.str();
+	return EXIT_SUCCESS;
+};
 
-int main()
+int main(int argc, char* argv[])
 {
+	if (argc >= 4 && std::string(argv[1]) == "--tune")
+	{
+		return run_tuning(std::stoull(argv[2]), std::vector<std::string>(argv + 3, argv + argc));
+	}
+	if (argc == 3 && std::string(argv[1]) == "--experiment")
+	{
+		return run_experiment(argv[2]);
+	}
+	if (argc == 4 && std::string(argv[1]) == "--island")
+	{
+		island_transport = std::make_shared<LocalSocketTransport>(ISLAND_SOCKET_PREFIX,
+			static_cast<unsigned int>(std::stoul(argv[2])), static_cast<unsigned int>(std::stoul(argv[3])), TOPOLOGY);
+	}
 	test();
 	/*ackley_function.SetDimensions(20);
 	Egg solution = std::valarray<double>(0.0, 20);
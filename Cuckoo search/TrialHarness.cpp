@@ -0,0 +1,210 @@
+#include "TrialHarness.h"
+
+#include <chrono>
+#include <atomic>
+#include <memory>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+double GetThreadCpuTime()
+{
+#ifdef _WIN32
+	FILETIME creation_time, exit_time, kernel_time, user_time;
+	GetThreadTimes(GetCurrentThread(), &creation_time, &exit_time, &kernel_time, &user_time);
+	const unsigned long long kernel = (static_cast<unsigned long long>(kernel_time.dwHighDateTime) << 32) | kernel_time.dwLowDateTime;
+	const unsigned long long user = (static_cast<unsigned long long>(user_time.dwHighDateTime) << 32) | user_time.dwLowDateTime;
+	return double(kernel + user) * 1e-7;
+#else
+	timespec time;
+	clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time);
+	return double(time.tv_sec) + double(time.tv_nsec) * 1e-9;
+#endif
+};
+
+TrialHarness::TrialHarness(const CuckooSearch& cuckoo_search, unsigned int trials, std::uint64_t base_seed) :
+	m_cuckoo_search(cuckoo_search), m_trials(trials), m_concurrent_trials(0), m_base_seed(base_seed), m_total_wall_seconds(0.0)
+{
+};
+
+const std::vector<TrialResult>& TrialHarness::RunMin()
+{
+	return Run(true);
+};
+
+const std::vector<TrialResult>& TrialHarness::RunMax()
+{
+	return Run(false);
+};
+
+const std::vector<TrialResult>& TrialHarness::Run(bool minimize)
+{
+	m_results.assign(m_trials, TrialResult());
+	const auto start_time = std::chrono::steady_clock::now();
+
+	//Searches of trials are called from loop body, so their own parallel loops run serially
+	std::shared_ptr<Executor> executor = Executor::Create(std::min(m_trials, (m_concurrent_trials == 0) ?
+		std::thread::hardware_concurrency() : m_concurrent_trials));
+	executor->ParallelFor(0, m_trials, [&](unsigned int trial)
+	{
+		m_results[trial] = RunTrial(trial, minimize);
+	});
+
+	m_total_wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+	return m_results;
+};
+
+TrialResult TrialHarness::RunTrial(unsigned int trial, bool minimize) const
+{
+	TrialResult result;
+	result.trial = trial;
+	RandomEngine seeds(m_base_seed, trial);
+	result.seed = seeds();
+
+	//Each trial counts calls of own copy of objective function, cache hits aren't calls
+	auto evaluations = std::make_shared<std::atomic<std::uint64_t>>(0);
+	const ObjectiveFunction function = m_cuckoo_search.GetObjectiveFunction();
+	ObjectiveFunction uncached_function(function);
+	uncached_function.DisableCache();
+	ObjectiveFunction counted_function(function);
+	counted_function.SetBatchFunction([uncached_function, evaluations](const double* points, unsigned int count, unsigned int,
+		unsigned int stride, double* fitness)
+	{
+		*evaluations += count;
+		uncached_function.Evaluate(points, count, stride, fitness);
+	});
+	if (function.HasIncrementalFunction())
+	{
+		const IncrementalFunction incremental_function = function.GetIncrementalFunction();
+		counted_function.SetIncrementalFunction([incremental_function, evaluations](const double* point, const double* previous_point,
+			double previous_fitness, const unsigned int* changed, unsigned int count)
+		{
+			++*evaluations;
+			return incremental_function(point, previous_point, previous_fitness, changed, count);
+		});
+	}
+	//Trials don't share cache, so they don't depend on order of trials
+	const std::shared_ptr<EvaluationCache> cache = function.GetCache();
+	if (cache)
+	{
+		counted_function.EnableCache(cache->GetTolerance(), cache->GetCapacity());
+	}
+
+	CuckooSearch cuckoo_search(m_cuckoo_search);
+	StatisticsHandler no_statistics;
+	cuckoo_search.SetStatisticsHandler(&no_statistics);
+	cuckoo_search.SetObjectiveFunction(counted_function);
+	cuckoo_search.SetSeed(result.seed);
+	//Copies of search share writer of one file, so trials would overwrite checkpoints of each other
+	if (cuckoo_search.GetCheckpointInterval() > 0)
+	{
+		cuckoo_search.SetCheckpointing(cuckoo_search.GetCheckpointPath() + ".trial" + std::to_string(trial), cuckoo_search.GetCheckpointInterval());
+	}
+
+	const auto start_time = std::chrono::steady_clock::now();
+	const double start_cpu_time = GetThreadCpuTime();
+	if (minimize)
+	{
+		cuckoo_search.FindMin();
+	}
+	else
+	{
+		cuckoo_search.FindMax();
+	}
+	result.cpu_seconds = GetThreadCpuTime() - start_cpu_time;
+	result.wall_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count();
+
+	result.best_fitness = cuckoo_search.GetCurrentBestValue();
+	result.best_solution = cuckoo_search.GetCurrentBestNest().GetSolutions();
+	result.generations = cuckoo_search.GetCurrentGeneration() - 1;
+	result.stop_reason = cuckoo_search.GetStopReason();
+	result.evaluations = evaluations->load();
+	result.evaluations_per_second = (result.wall_seconds > 0.0) ? double(result.evaluations) / result.wall_seconds : 0.0;
+	return result;
+};
+
+void TrialHarness::WriteCsv(std::ostream& o_stream) const
+{
+	const std::string function_name = m_cuckoo_search.GetObjectiveFunction().GetName();
+	o_stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+	o_stream << "function,trial,seed,best_fitness,generations,stop_reason,evaluations,wall_seconds,cpu_seconds,evaluations_per_second\n";
+	for (const TrialResult& result : m_results)
+	{
+		o_stream << "\"" << function_name << "\"," << result.trial << "," << result.seed << "," << result.best_fitness << "," <<
+			result.generations << "," << GetStopReasonName(result.stop_reason) << "," << result.evaluations << "," << result.wall_seconds << "," << result.cpu_seconds << "," <<
+			result.evaluations_per_second << "\n";
+	}
+};
+
+//Quotes, backslashes and control characters of JSON string are escaped
+static std::string EscapeJson(const std::string& text)
+{
+	std::string escaped;
+	for (char symbol : text)
+	{
+		if (symbol == '"' || symbol == '\\')
+		{
+			escaped += '\\';
+			escaped += symbol;
+		}
+		else if (static_cast<unsigned char>(symbol) < 0x20)
+		{
+			const char* digits = "0123456789abcdef";
+			escaped += "\\u00";
+			escaped += digits[(symbol >> 4) & 0xF];
+			escaped += digits[symbol & 0xF];
+		}
+		else
+		{
+			escaped += symbol;
+		}
+	}
+	return escaped;
+};
+
+//JSON has no infinity and NaN, they are written as null
+struct JsonNumber
+{
+	double value;
+};
+
+static std::ostream& operator<<(std::ostream& o_stream, const JsonNumber& number)
+{
+	if (std::isfinite(number.value))
+		return o_stream << number.value;
+	return o_stream << "null";
+};
+
+void TrialHarness::WriteJson(std::ostream& o_stream) const
+{
+	const CuckooSearch& cs = m_cuckoo_search;
+	o_stream << std::setprecision(std::numeric_limits<double>::max_digits10);
+	o_stream << "{\n";
+	o_stream << "\t\"function\": \"" << EscapeJson(cs.GetObjectiveFunction().GetName()) << "\",\n";
+	o_stream << "\t\"dimensions\": " << cs.GetObjectiveFunction().GetNumberOfDimensions() << ",\n";
+	o_stream << "\t\"nests\": " << cs.GetNumberOfNests() << ",\n";
+	o_stream << "\t\"max_generations\": " << cs.GetMaxGenerations() << ",\n";
+	o_stream << "\t\"lazy_cuckoo\": " << (cs.IsLazyCuckoo() ? "true" : "false") << ",\n";
+	//Seeds are strings: 64-bit integers don't fit into doubles of JSON readers
+	o_stream << "\t\"base_seed\": \"" << m_base_seed << "\",\n";
+	o_stream << "\t\"total_wall_seconds\": " << JsonNumber{ m_total_wall_seconds } << ",\n";
+	o_stream << "\t\"trials\": [";
+	for (size_t i = 0; i < m_results.size(); ++i)
+	{
+		const TrialResult& result = m_results[i];
+		o_stream << (i == 0 ? "\n" : ",\n");
+		o_stream << "\t\t{ \"trial\": " << result.trial << ", \"seed\": \"" << result.seed << "\"" <<
+			", \"best_fitness\": " << JsonNumber{ result.best_fitness } << ", \"generations\": " << result.generations <<
+			", \"stop_reason\": \"" << GetStopReasonName(result.stop_reason) << "\"" <<
+			", \"evaluations\": " << result.evaluations << ", \"wall_seconds\": " << JsonNumber{ result.wall_seconds } <<
+			", \"cpu_seconds\": " << JsonNumber{ result.cpu_seconds } << ", \"evaluations_per_second\": " << JsonNumber{ result.evaluations_per_second } << " }";
+	}
+	o_stream << "\n\t]\n}\n";
+};
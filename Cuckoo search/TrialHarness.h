@@ -0,0 +1,72 @@
+/*
+	Description:
+		Benchmark harness: runs independent trials of one CuckooSearch concurrently.
+		Each trial is a copy of search with own seed (derived from base seed and number of trial),
+		trials are distributed between threads, search of each trial runs on its thread.
+		For each trial wall time, CPU time of its thread, number of evaluations and
+		evaluations per second are measured. Results are written as CSV or JSON.
+		Checkpointing of given search is kept: trial t writes checkpoints to file "<path>.trial<t>".
+*/
+
+#ifndef TRIAL_HARNESS
+#define TRIAL_HARNESS
+
+#include "CuckooSearch.h"
+#include "Executor.h"
+
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstdint>
+
+struct TrialResult
+{
+	unsigned int	trial;
+	std::uint64_t	seed;
+	double			best_fitness;
+	Egg				best_solution;
+	unsigned int	generations;
+	StopReason		stop_reason;
+	std::uint64_t	evaluations;
+	double			wall_seconds;
+	double			cpu_seconds;
+	double			evaluations_per_second;
+};
+
+class TrialHarness
+{
+public:
+	TrialHarness(const CuckooSearch& cuckoo_search, unsigned int trials = 1, std::uint64_t base_seed = 0);
+
+	//Runs all trials, results are ordered by trial
+	const std::vector<TrialResult>& RunMin();
+	const std::vector<TrialResult>& RunMax();
+	//Runs one trial on calling thread (results of harness aren't changed)
+	TrialResult RunTrial(unsigned int trial, bool minimize) const;
+
+	void WriteCsv(std::ostream& o_stream) const;
+	void WriteJson(std::ostream& o_stream) const;
+
+	//trials = 0 - one trial for each hardware thread
+	inline void SetConcurrentTrials(unsigned int trials) { m_concurrent_trials = trials; };
+	inline void SetNumberOfTrials(unsigned int trials) { m_trials = trials; };
+	inline void SetBaseSeed(std::uint64_t seed) { m_base_seed = seed; };
+	inline const std::vector<TrialResult>& GetResults() const { return m_results; };
+	//Wall time of all trials
+	inline double GetTotalWallTime() const { return m_total_wall_seconds; };
+
+private:
+	CuckooSearch				m_cuckoo_search;
+	unsigned int				m_trials;
+	unsigned int				m_concurrent_trials;
+	std::uint64_t				m_base_seed;
+	std::vector<TrialResult>	m_results;
+	double						m_total_wall_seconds;
+
+	const std::vector<TrialResult>& Run(bool minimize);
+};
+
+//CPU time of calling thread in seconds
+double GetThreadCpuTime();
+
+#endif // !TRIAL_HARNESS
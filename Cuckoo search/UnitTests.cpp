@@ -0,0 +1,504 @@
+/*
+	Description:
+		Unit tests of search (target cuckoo_unit_tests of CMakeLists.txt, run by ctest).
+		Program runs the test group, which name is given as argument, or all groups without argument,
+		and returns 1, if any check fails.
+		Groups: random_streams, ranking, checkpoint, search_budget, trial_harness, convergence_trace, evaluation_cache, constraints.
+*/
+
+#include "CuckooSearch.h"
+#include "AsyncCuckooSearch.h"
+#include "Constraints.h"
+#include "ConvergenceTrace.h"
+#include "EvaluationCache.h"
+#include "Random.h"
+#include "Ranking.h"
+#include "TrialHarness.h"
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <valarray>
+#include <atomic>
+#include <algorithm>
+#include <functional>
+#include <cmath>
+#include <cstdio>
+#include <sstream>
+#include <limits>
+
+static unsigned int failures = 0;
+
+#define CHECK(condition) \
+	do \
+	{ \
+		if (!(condition)) \
+		{ \
+			std::cerr << __FILE__ << ":" << __LINE__ << ": check failed: " #condition "\n"; \
+			++failures; \
+		} \
+	} while (false)
+
+const unsigned int DIMENSIONS = 5;
+const std::uint64_t SEED = 42;
+
+static ObjectiveFunction GetSphere()
+{
+	return ObjectiveFunction([](const std::valarray<double>& x) { return (x * x).sum(); }, DIMENSIONS, Bounds{ -5.0, 5.0 }, "Sphere");
+};
+
+static CuckooSearch GetSearch(unsigned int generations)
+{
+	return CuckooSearch(GetSphere(), 24, Step(1e-3, 1e-1, DIMENSIONS), Lambda(0.3, 1.99), 0.25, generations);
+};
+
+static bool IsSameSolution(const std::valarray<double>& ls, const std::valarray<double>& rs)
+{
+	if (ls.size() != rs.size())
+		return false;
+	for (size_t i = 0; i < ls.size(); ++i)
+	{
+		if (ls[i] != rs[i])
+			return false;
+	}
+	return true;
+};
+
+static void TestRandomStreams()
+{
+	RandomEngine first(SEED, 3);
+	RandomEngine second(SEED, 3);
+	RandomEngine other_stream(SEED, 4);
+	bool is_same = true;
+	bool is_other_same = true;
+	for (unsigned int i = 0; i < 1000; ++i)
+	{
+		const std::uint64_t value = first();
+		is_same = is_same && value == second();
+		is_other_same = is_other_same && value == other_stream();
+	}
+	CHECK(is_same);
+	CHECK(!is_other_same);
+
+	RandomEngine uniform(SEED);
+	for (unsigned int i = 0; i < 1000; ++i)
+	{
+		const double value = uniform.Uniform(-2.0, 3.0);
+		CHECK(value >= -2.0 && value < 3.0);
+		CHECK(uniform.UniformIndex(7) < 7);
+	}
+
+	//Nests have own streams, so seeded search gives equal result on any number of threads
+	std::vector<unsigned int> threads = { 1, 2, 4 };
+	std::vector<Nest> best_nests;
+	for (unsigned int thread_count : threads)
+	{
+		CuckooSearch cuckoo_search = GetSearch(60);
+		cuckoo_search.SetSeed(SEED);
+		cuckoo_search.SetNumberOfThreads(thread_count);
+		cuckoo_search.FindMin();
+		best_nests.push_back(cuckoo_search.GetCurrentBestNest());
+	}
+	for (size_t i = 1; i < best_nests.size(); ++i)
+	{
+		CHECK(best_nests[i].GetFitness() == best_nests[0].GetFitness());
+		CHECK(IsSameSolution(best_nests[i].GetSolutions(), best_nests[0].GetSolutions()));
+	}
+};
+
+static void CheckRanking(const Ranking& ranking, const std::vector<double>& fitness)
+{
+	std::vector<unsigned int> order(fitness.size());
+	for (unsigned int i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	//Equal fitness is ordered by index
+	std::sort(order.begin(), order.end(), [&fitness](unsigned int ls, unsigned int rs)
+	{
+		return fitness[ls] < fitness[rs] || (fitness[ls] == fitness[rs] && ls < rs);
+	});
+	CHECK(ranking.GetOrder() == order);
+	CHECK(ranking.IsActual());
+	for (unsigned int rank = 0; rank < order.size(); ++rank)
+	{
+		CHECK(ranking.GetRank(order[rank]) == rank);
+	}
+};
+
+static void TestRanking()
+{
+	const unsigned int size = 200;
+	const CompareFitness cmp_fitness = [](double ls, double rs) { return ls < rs; };
+	RandomEngine random_engine(SEED);
+	//Few values give many equal fitness
+	std::vector<double> fitness(size);
+	for (double& value : fitness)
+	{
+		value = static_cast<double>(random_engine.UniformIndex(50));
+	}
+
+	Ranking ranking;
+	ranking.Reset(size);
+	ranking.Update(fitness.data(), cmp_fitness);
+	CheckRanking(ranking, fitness);
+
+	//Few changes are merged, many changes lead to full sort
+	for (unsigned int changes : { 1u, 5u, 20u, 150u })
+	{
+		for (unsigned int round = 0; round < 10; ++round)
+		{
+			for (unsigned int i = 0; i < changes; ++i)
+			{
+				const unsigned int index = random_engine.UniformIndex(size);
+				fitness[index] = static_cast<double>(random_engine.UniformIndex(50));
+				ranking.MarkChanged(index);
+			}
+			ranking.Update(fitness.data(), cmp_fitness);
+			CheckRanking(ranking, fitness);
+		}
+	}
+};
+
+static void TestCheckpoint()
+{
+	const unsigned int generations = 80;
+	const std::string file_path = "unit_tests_checkpoint.bin";
+
+	CuckooSearch full_search = GetSearch(generations);
+	full_search.SetSeed(SEED);
+	full_search.FindMin();
+
+	CuckooSearch stopped_search = GetSearch(generations);
+	stopped_search.SetSeed(SEED);
+	stopped_search.StartMin();
+	for (unsigned int i = 0; i < generations / 2; ++i)
+	{
+		stopped_search.NextGeneration();
+	}
+	stopped_search.SaveCheckpoint(file_path);
+
+	CuckooSearch resumed_search = GetSearch(generations);
+	resumed_search.SetSeed(SEED);
+	resumed_search.Resume(file_path);
+	std::remove(file_path.c_str());
+
+	CHECK(resumed_search.GetCurrentBestValue() == full_search.GetCurrentBestValue());
+	CHECK(IsSameSolution(resumed_search.GetCurrentBestNest().GetSolutions(), full_search.GetCurrentBestNest().GetSolutions()));
+	CHECK(resumed_search.GetCurrentGeneration() == full_search.GetCurrentGeneration());
+	CHECK(resumed_search.GetEvaluations() == full_search.GetEvaluations());
+};
+
+static void TestSearchBudget()
+{
+	//Lazy cuckoo evaluates several candidates per flight, so the rest of budget can be less than flight
+	for (bool lazy_cuckoo : { false, true })
+	{
+		for (unsigned long long max_evaluations : { 1000ull, 1234ull, 5000ull })
+		{
+			SearchBudget budget;
+			budget.SetMaxEvaluations(max_evaluations);
+			AsyncCuckooSearch async_search(GetSphere(), 24, Step(1e-3, 1e-1, DIMENSIONS), Lambda(0.3, 1.99), 0.25, 100000,
+				[]() { return true; }, lazy_cuckoo);
+			async_search.SetNumberOfThreads(2);
+			async_search.SetBudget(budget);
+			async_search.FindMin();
+			CHECK(async_search.GetEvaluations() <= max_evaluations);
+			CHECK(async_search.GetEvaluations() + 1 >= max_evaluations);
+			CHECK(async_search.GetStopReason() == StopReason::MAX_EVALUATIONS);
+
+			CuckooSearch cuckoo_search(GetSphere(), 24, Step(1e-3, 1e-1, DIMENSIONS), Lambda(0.3, 1.99), 0.25, 100000,
+				[]() { return true; }, lazy_cuckoo);
+			cuckoo_search.SetFlightBlockSize(7);
+			cuckoo_search.SetBudget(budget);
+			cuckoo_search.FindMin();
+			CHECK(cuckoo_search.GetEvaluations() <= max_evaluations);
+			CHECK(cuckoo_search.GetEvaluations() + 1 >= max_evaluations);
+			CHECK(cuckoo_search.GetStopReason() == StopReason::MAX_EVALUATIONS);
+		}
+	}
+};
+
+static void TestTrialJson()
+{
+	//Name with quotes and backslash, fitness isn't finite
+	ObjectiveFunction function([](const std::valarray<double>&) { return std::numeric_limits<double>::infinity(); },
+		DIMENSIONS, Bounds{ -5.0, 5.0 }, "Sphere \"quoted\" C:\\path");
+	TrialHarness harness(CuckooSearch(function, 8, Step(1e-3, 1e-1, DIMENSIONS), Lambda(0.3, 1.99), 0.25, 3), 2, SEED);
+	harness.RunMin();
+	std::ostringstream json;
+	harness.WriteJson(json);
+	const std::string text = json.str();
+	CHECK(text.find("\"function\": \"Sphere \\\"quoted\\\" C:\\\\path\"") != std::string::npos);
+	CHECK(text.find("\"best_fitness\": null") != std::string::npos);
+	CHECK(text.find("inf") == std::string::npos);
+	CHECK(text.find("nan") == std::string::npos);
+};
+
+static void TestTrialHarness()
+{
+	//Concurrent trials have own copies of search, they give the same results as trials one by one
+	const unsigned int trials = 8;
+	const std::string file_path = "unit_tests_trials.bin";
+	CuckooSearch cuckoo_search = GetSearch(40);
+	cuckoo_search.UseLazyCuckoo();
+	cuckoo_search.SetCheckpointing(file_path, 10);
+	TrialHarness harness(cuckoo_search, trials, SEED);
+	harness.SetConcurrentTrials(4);
+	const std::vector<TrialResult> results = harness.RunMin();
+	CHECK(results.size() == trials);
+	for (unsigned int trial = 0; trial < results.size() && trial < trials; ++trial)
+	{
+		const TrialResult result = harness.RunTrial(trial, true);
+		CHECK(results[trial].trial == trial);
+		CHECK(results[trial].seed == result.seed);
+		CHECK(results[trial].best_fitness == result.best_fitness);
+		CHECK(IsSameSolution(results[trial].best_solution, result.best_solution));
+		CHECK(results[trial].evaluations == result.evaluations);
+		CHECK(results[trial].evaluations > 0);
+
+		//Each trial writes own checkpoints, the last one is written after the last generation
+		const std::string trial_path = file_path + ".trial" + std::to_string(trial);
+		CuckooSearch resumed_search = GetSearch(40);
+		resumed_search.UseLazyCuckoo();
+		resumed_search.LoadCheckpoint(trial_path);
+		std::remove(trial_path.c_str());
+		CHECK(resumed_search.GetSeed() == results[trial].seed);
+		CHECK(resumed_search.GetCurrentBestValue() == results[trial].best_fitness);
+	}
+	TestTrialJson();
+};
+
+static void CheckTrace(TraceCompression compression)
+{
+	const std::string file_path = "unit_tests_trace.bin";
+	TraceHeader header;
+	header.function_name = "Sphere";
+	header.dimensions = DIMENSIONS;
+	header.nests = 24;
+	header.iterations = 1000;
+	header.min_lambda = 0.3;
+	header.max_lambda = 1.99;
+	header.min_step = 1e-3;
+	header.max_step = 1e-1;
+	header.probability = 0.25;
+	header.lazy_cuckoo = true;
+	header.seed = SEED;
+	header.test = 7;
+	header.compression = compression;
+
+	//Records cross blocks of writer, some of them repeat previous record
+	const unsigned int records = TraceWriter::BLOCK_SIZE * 2 + 17;
+	RandomEngine random_engine(SEED);
+	std::vector<std::uint32_t> generations;
+	std::vector<double> fitness;
+	std::vector<double> solutions;
+	std::vector<double> solution(DIMENSIONS, 0.0);
+	double value = 100.0;
+	{
+		TraceWriter writer(file_path, header);
+		for (unsigned int i = 0; i < records; ++i)
+		{
+			if (i % 3 != 0)
+			{
+				value -= random_engine.Uniform();
+				solution[random_engine.UniformIndex(DIMENSIONS)] = random_engine.Uniform(-5.0, 5.0);
+			}
+			writer.Append(i, value, solution.data());
+			generations.push_back(i);
+			fitness.push_back(value);
+			solutions.insert(solutions.end(), solution.begin(), solution.end());
+		}
+		writer.Flush();
+	}
+
+	const ConvergenceTrace trace = ReadTrace(file_path);
+	std::remove(file_path.c_str());
+	CHECK(trace.header.function_name == header.function_name);
+	CHECK(trace.header.dimensions == header.dimensions);
+	CHECK(trace.header.nests == header.nests);
+	CHECK(trace.header.iterations == header.iterations);
+	CHECK(trace.header.min_lambda == header.min_lambda);
+	CHECK(trace.header.max_lambda == header.max_lambda);
+	CHECK(trace.header.min_step == header.min_step);
+	CHECK(trace.header.max_step == header.max_step);
+	CHECK(trace.header.probability == header.probability);
+	CHECK(trace.header.lazy_cuckoo == header.lazy_cuckoo);
+	CHECK(trace.header.seed == header.seed);
+	CHECK(trace.header.test == header.test);
+	CHECK(trace.header.compression == header.compression);
+	CHECK(trace.GetSize() == records);
+	CHECK(trace.generations == generations);
+	CHECK(trace.fitness == fitness);
+	CHECK(trace.solutions == solutions);
+};
+
+static void TestConvergenceTrace()
+{
+	CheckTrace(TraceCompression::NONE);
+	CheckTrace(TraceCompression::DELTA);
+};
+
+static void TestEvaluationCache()
+{
+	std::atomic<unsigned int> calls(0);
+	ObjectiveFunction function([&calls](const std::valarray<double>& x)
+	{
+		++calls;
+		return (x * x).sum();
+	}, DIMENSIONS, Bounds{ -5.0, 5.0 }, "Sphere");
+	function.EnableCache();
+	const std::shared_ptr<EvaluationCache> cache = function.GetCache();
+	CHECK(cache != nullptr);
+
+	//All ways of evaluation use cache
+	const std::valarray<double> point = { 1.0, 2.0, 3.0, 4.0, 5.0 };
+	CHECK(function(point) == 55.0);
+	CHECK(function(point) == 55.0);
+	CHECK(function(&point[0]) == 55.0);
+	CHECK(calls == 1);
+	CHECK(cache->GetMisses() == 1);
+	CHECK(cache->GetHits() == 2);
+
+	//Rows 0 and 2 are equal, row 1 is the point above
+	const unsigned int stride = DIMENSIONS + 1;
+	std::vector<double> points(3 * stride, 0.0);
+	for (unsigned int j = 0; j < DIMENSIONS; ++j)
+	{
+		points[j] = -1.0;
+		points[stride + j] = point[j];
+		points[2 * stride + j] = -1.0;
+	}
+	std::vector<double> fitness(3);
+	function.Evaluate(points.data(), 3, stride, fitness.data());
+	CHECK(fitness[0] == 5.0);
+	CHECK(fitness[1] == 55.0);
+	CHECK(fitness[2] == 5.0);
+	CHECK(calls <= 3);
+	CHECK(cache->GetHits() + cache->GetMisses() == 6);
+
+	//Copies share cache
+	ObjectiveFunction copy = function;
+	const unsigned int calls_before_copy = calls;
+	CHECK(copy(point) == 55.0);
+	CHECK(calls == calls_before_copy);
+};
+
+static void TestConstraints()
+{
+	const std::vector<Bounds> bounds(DIMENSIONS, Bounds{ -5.0, 5.0 });
+	//Sum of coordinates is at least 1: -x1 - ... - xn <= -1
+	ConstraintSet constraints(ConstraintHandling::FEASIBILITY_RULE);
+	constraints.AddLinearInequality(std::vector<double>(DIMENSIONS, -1.0), -1.0);
+
+	std::vector<double> feasible(DIMENSIONS, 1.0);
+	CHECK(constraints.GetViolation(feasible.data(), DIMENSIONS) == 0.0);
+	CHECK(!constraints.Repair(feasible.data(), bounds));
+
+	std::vector<double> infeasible(DIMENSIONS, -1.0);
+	CHECK(std::fabs(constraints.GetViolation(infeasible.data(), DIMENSIONS) - 6.0) < 1e-12);
+	CHECK(constraints.Repair(infeasible.data(), bounds));
+	CHECK(constraints.GetViolation(infeasible.data(), DIMENSIONS) < 1e-9);
+	for (unsigned int j = 0; j < DIMENSIONS; ++j)
+	{
+		CHECK(infeasible[j] >= bounds[j].lower_bound && infeasible[j] <= bounds[j].upper_bound);
+	}
+	CHECK(constraints.RepairCoordinate(7.0, bounds[0]) == 5.0);
+	constraints.SetBoundsRepair(BoundsRepair::REFLECTION);
+	CHECK(constraints.RepairCoordinate(6.0, bounds[0]) == 4.0);
+	CHECK(constraints.RepairCoordinate(-5.5, bounds[0]) == -4.5);
+
+	//Objective isn't evaluated for infeasible points
+	std::atomic<unsigned int> calls(0);
+	ObjectiveFunction objective([&calls](const std::valarray<double>& x)
+	{
+		++calls;
+		return (x * x).sum();
+	}, DIMENSIONS, bounds, "Sphere");
+	const ObjectiveFunction wrapped = constraints.Wrap(objective, true);
+	const std::vector<double> point(DIMENSIONS, 1.0);
+	const std::vector<double> small_violation(DIMENSIONS, 0.1);
+	const std::vector<double> big_violation(DIMENSIONS, -1.0);
+	const double feasible_fitness = wrapped(point.data());
+	const double small_fitness = wrapped(small_violation.data());
+	const double big_fitness = wrapped(big_violation.data());
+	CHECK(calls == 1);
+	CHECK(feasible_fitness == 5.0);
+	CHECK(ConstraintSet::IsFeasibleFitness(feasible_fitness));
+	CHECK(!ConstraintSet::IsFeasibleFitness(small_fitness));
+	CHECK(!ConstraintSet::IsFeasibleFitness(big_fitness));
+	CHECK(std::fabs(ConstraintSet::GetFitnessViolation(small_fitness) - 0.5) < 1e-9);
+	CHECK(std::fabs(ConstraintSet::GetFitnessViolation(big_fitness) - 6.0) < 1e-9);
+
+	//Feasible point is better than infeasible one, infeasible points are compared by violation
+	for (bool minimize : { true, false })
+	{
+		const ObjectiveFunction wrapped_objective = constraints.Wrap(objective, minimize);
+		const CompareFitness cmp_fitness = constraints.GetCompareFitness(minimize);
+		const double small = wrapped_objective(small_violation.data());
+		const double big = wrapped_objective(big_violation.data());
+		const double good = minimize ? 1.0 : 100.0;
+		const double bad = minimize ? 100.0 : 1.0;
+		CHECK(cmp_fitness(good, bad));
+		CHECK(!cmp_fitness(bad, good));
+		CHECK(cmp_fitness(bad, small));
+		CHECK(!cmp_fitness(small, bad));
+		CHECK(cmp_fitness(small, big));
+		CHECK(!cmp_fitness(big, small));
+
+		//Lazy cuckoo chooses result of flight by comparison of search
+		const LazyCuckoo cuckoo(objective);
+		const double infeasible_candidates[2] = { big, small };
+		CHECK(cuckoo.SelectCandidate(good, infeasible_candidates, cmp_fitness) == Cuckoo::HOST_CANDIDATE);
+		CHECK(cuckoo.SelectCandidate(big, infeasible_candidates, cmp_fitness) == 1);
+		const double feasible_candidates[2] = { bad, good };
+		CHECK(cuckoo.SelectCandidate(small, feasible_candidates, cmp_fitness) == 1);
+		CHECK(cuckoo.SelectCandidate(good, feasible_candidates, cmp_fitness) == 1);
+	}
+};
+
+struct UnitTest
+{
+	std::string				name;
+	std::function<void()>	test;
+};
+
+int main(int argc, char* argv[])
+{
+	const std::vector<UnitTest> tests = {
+		{ "random_streams", TestRandomStreams },
+		{ "ranking", TestRanking },
+		{ "checkpoint", TestCheckpoint },
+		{ "search_budget", TestSearchBudget },
+		{ "trial_harness", TestTrialHarness },
+		{ "convergence_trace", TestConvergenceTrace },
+		{ "evaluation_cache", TestEvaluationCache },
+		{ "constraints", TestConstraints }
+	};
+	const std::string filter = (argc > 1) ? argv[1] : "";
+
+	bool is_found = false;
+	for (const UnitTest& unit_test : tests)
+	{
+		if (!filter.empty() && unit_test.name != filter)
+			continue;
+		is_found = true;
+		const unsigned int previous_failures = failures;
+		try
+		{
+			unit_test.test();
+		}
+		catch (const std::exception& error)
+		{
+			std::cerr << "Exception: " << error.what();
+			++failures;
+		}
+		std::cout << unit_test.name << ": " << ((failures == previous_failures) ? "passed" : "failed") << "\n";
+	}
+	if (!is_found)
+	{
+		std::cerr << "Unknown test " << filter << "\n";
+		return 2;
+	}
+	return (failures == 0) ? 0 : 1;
+};